@@ -0,0 +1,76 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Game
+#include "GameAssets.h"
+#include "MapGenerator.h"
+#include "Settings.h"
+#include "Sprites.h"
+
+// Core
+#include "Core/ResourceLocator.h"
+#include "Core/Scene.h"
+#include "Core/Utils.h"
+
+// System
+#include <set>
+#include <string>
+
+//------------------------------------------------------------------------------
+// Registers and loads every game asset once, shared by all benchmarks
+inline AssetManager& GetGameAssets()
+{
+	static AssetManager& assetManager = []() -> AssetManager& {
+		ResourceLocator& locator = ResourceLocator::GetInstance();
+		locator.Initialize(ApplicationConfig{ WIDTH, HEIGHT, 32, CAPTION });
+		AssetManager& manager = locator.GetAssetManager();
+		RegisterGameAssets(manager, AssetLoadPolicy::Eager);
+		return manager;
+	}();
+	return assetManager;
+}
+
+//------------------------------------------------------------------------------
+// Generates and registers the map the first time a scenario and scale is asked for
+inline const std::string& PrepareScenarioMap(const MapScenario& scenario, uint32_t areaScale)
+{
+	static std::set<std::string> preparedIds;
+	const std::string mapId = GetScenarioMapId(scenario, areaScale);
+	auto [it, isNew] = preparedIds.insert(mapId);
+	if (isNew)
+	{
+		GetGameAssets().RegisterAssetFile<TiledMap>(mapId, GenerateScenarioMap(scenario, areaScale));
+		GetGameAssets().ProcessAssetQueue();
+	}
+	return *it;
+}
+
+//------------------------------------------------------------------------------
+// Creates untextured sprites scattered over the map, from a fixed seed so every
+// run works on the same input
+inline std::vector<GameObject*> CreateSprites(Scene& scene, size_t count)
+{
+	static const sf::Texture texture;
+	const sf::IntRect textureRegion(sf::Vector2i(), sf::Vector2i(16, 16));
+
+	std::vector<GameObject*> sprites;
+	sprites.reserve(count);
+	SeedRandom(1);
+	for (size_t index = 0; index < count; index++)
+	{
+		const sf::Vector2f position(static_cast<float>(RandomInteger(0, 3200)), static_cast<float>(RandomInteger(0, 2560)));
+		sprites.push_back(scene.CreateGameObject<Generic>(texture, textureRegion, sf::Vector2f(), position));
+	}
+	return sprites;
+}
+
+//------------------------------------------------------------------------------
+inline void SpawnSprites(Scene& scene, Group& group, size_t count)
+{
+	for (GameObject* sprite : CreateSprites(scene, count))
+	{
+		group.Add(sprite);
+	}
+	scene.PostUpdate();
+}
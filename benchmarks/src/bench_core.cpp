@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.h"
+
+namespace {
+
+	void BM_ProcessAssetQueue(benchmark::State& state)
+	{
+		const AssetLoadPolicy policy = static_cast<AssetLoadPolicy>(state.range(0));
+		std::unique_ptr<AssetManager> assetManager;
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			assetManager = std::make_unique<AssetManager>();
+			assetManager->SetLoadPolicy<Texture>(policy);
+			assetManager->LoadAssetsFromManifest<Texture>("../../config/textures.cfg");
+			state.ResumeTiming();
+
+			assetManager->ProcessAssetQueue();
+		}
+		state.SetLabel(policy == AssetLoadPolicy::Eager ? "eager" : "lazy");
+	}
+	BENCHMARK(BM_ProcessAssetQueue)
+		->Arg(static_cast<int64_t>(AssetLoadPolicy::Eager))
+		->Arg(static_cast<int64_t>(AssetLoadPolicy::Lazy))
+		->Unit(benchmark::kMillisecond);
+
+	void BM_RandomInteger(benchmark::State& state)
+	{
+		SeedRandom(1);
+		const int32_t max = static_cast<int32_t>(state.range(0));
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(RandomInteger(0, max));
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+	BENCHMARK(BM_RandomInteger)->Arg(2)->Arg(1 << 20);
+}
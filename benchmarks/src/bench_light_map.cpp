@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include "Core/Lighting/LightMap.h"
+
+#include <algorithm>
+
+namespace {
+
+	// The default map at half tile cells, lit by a few fixed lamps
+	LightMap CreateLightMap(SimdLevel level)
+	{
+		LightMap lightMap(sf::Vector2f(3200.0f, 2560.0f), 32.0f);
+		lightMap.SetSimdLevel(level);
+		lightMap.SetAmbient(sf::Color(70, 80, 130));
+		lightMap.AddLight({ { 1500.0f, 1400.0f }, 400.0f, sf::Color(255, 190, 120) });
+		lightMap.AddLight({ { 960.0f, 440.0f }, 320.0f, sf::Color(255, 170, 90) });
+		lightMap.Update();
+		return lightMap;
+	}
+
+	const char* GetSimdLabel(SimdLevel level)
+	{
+		return level == SimdLevel::Avx2 ? "avx2" : level == SimdLevel::Sse2 ? "sse2" : "scalar";
+	}
+
+	// A lantern following the player, range(1) is its radius in pixels and
+	// range(0) the SimdLevel, clamped to what the CPU supports
+	void BM_LightMapMoveLight(benchmark::State& state)
+	{
+		const SimdLevel level = std::min(static_cast<SimdLevel>(state.range(0)), GetSupportedSimdLevel());
+		LightMap lightMap = CreateLightMap(level);
+		const LightId lantern = lightMap.AddLight({ { 1000.0f, 1000.0f }, static_cast<float>(state.range(1)), sf::Color(255, 200, 140) });
+		lightMap.Update();
+
+		float offset = 0.0f;
+		for (auto _ : state)
+		{
+			offset = offset > 600.0f ? 0.0f : offset + 4.0f;
+			lightMap.MoveLight(lantern, { 1000.0f + offset, 1000.0f });
+			lightMap.Update();
+			benchmark::DoNotOptimize(lightMap.GetSummedCellCount());
+		}
+		state.SetLabel(GetSimdLabel(level));
+	}
+	BENCHMARK(BM_LightMapMoveLight)->ArgsProduct({ { 0, 1, 2 }, { 256, 512 } });
+
+	// Dusk, every pixel rewritten while the light sums stay
+	void BM_LightMapAmbientChange(benchmark::State& state)
+	{
+		LightMap lightMap = CreateLightMap(GetSupportedSimdLevel());
+		uint8_t level = 0;
+		for (auto _ : state)
+		{
+			level++;
+			lightMap.SetAmbient(sf::Color(level, level, 130));
+			lightMap.Update();
+		}
+		state.SetItemsProcessed(state.iterations() * lightMap.GetCellCount().x * lightMap.GetCellCount().y);
+	}
+	BENCHMARK(BM_LightMapAmbientChange);
+}
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include "Core/Collision/RectBatch.h"
+#include "Core/Utils.h"
+
+#include <vector>
+
+namespace {
+
+	// Hitbox sized rects scattered over the map from a fixed seed, the query
+	// box sits in an empty corner so every rect is tested
+	std::vector<sf::FloatRect> CreateRects(size_t count)
+	{
+		SeedRandom(1);
+		std::vector<sf::FloatRect> rects;
+		rects.reserve(count);
+		for (size_t index = 0; index < count; index++)
+		{
+			const sf::Vector2f position(static_cast<float>(RandomInteger(100, 3200)), static_cast<float>(RandomInteger(100, 2560)));
+			rects.emplace_back(position, sf::Vector2f(48.0f, 24.0f));
+		}
+		return rects;
+	}
+
+	const sf::FloatRect QUERY_BOX({ 0.0f, 0.0f }, { 40.0f, 60.0f });
+
+	void BM_FloatRectFindIntersection(benchmark::State& state)
+	{
+		const std::vector<sf::FloatRect> rects = CreateRects(static_cast<size_t>(state.range(0)));
+		for (auto _ : state)
+		{
+			size_t overlaps = 0;
+			for (const sf::FloatRect& rect : rects)
+			{
+				overlaps += rect.findIntersection(QUERY_BOX).has_value();
+			}
+			benchmark::DoNotOptimize(overlaps);
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_FloatRectFindIntersection)->RangeMultiplier(4)->Range(1024, 16384);
+
+	// range(1) is the SimdLevel, clamped to what the CPU supports
+	void BM_RectBatchFindFirstOverlap(benchmark::State& state)
+	{
+		RectBatch batch;
+		batch.SetSimdLevel(static_cast<SimdLevel>(state.range(1)));
+		for (const sf::FloatRect& rect : CreateRects(static_cast<size_t>(state.range(0))))
+		{
+			batch.Add(rect);
+		}
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(batch.FindFirstOverlap(QUERY_BOX));
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		state.SetLabel(batch.GetSimdLevel() == SimdLevel::Avx2 ? "avx2" : batch.GetSimdLevel() == SimdLevel::Sse2 ? "sse2" : "scalar");
+	}
+	BENCHMARK(BM_RectBatchFindFirstOverlap)->ArgsProduct({ { 1024, 4096, 16384 }, { 0, 1, 2 } });
+
+	void BM_RectBatchFindFirstContaining(benchmark::State& state)
+	{
+		RectBatch batch;
+		batch.SetSimdLevel(static_cast<SimdLevel>(state.range(1)));
+		for (const sf::FloatRect& rect : CreateRects(static_cast<size_t>(state.range(0))))
+		{
+			batch.Add(rect);
+		}
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(batch.FindFirstContaining(QUERY_BOX.getCenter()));
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_RectBatchFindFirstContaining)->ArgsProduct({ { 1024, 4096, 16384 }, { 0, 1, 2 } });
+
+	void BM_RectBatchOverlapMask(benchmark::State& state)
+	{
+		RectBatch batch;
+		batch.SetSimdLevel(static_cast<SimdLevel>(state.range(1)));
+		for (const sf::FloatRect& rect : CreateRects(static_cast<size_t>(state.range(0))))
+		{
+			batch.Add(rect);
+		}
+
+		std::vector<uint8_t> mask(batch.GetSize());
+		const sf::FloatRect viewRegion({ 640.0f, 360.0f }, { 1280.0f, 720.0f });
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(batch.ComputeOverlapMask(viewRegion, mask.data()));
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+	}
+	BENCHMARK(BM_RectBatchOverlapMask)->ArgsProduct({ { 1024, 4096, 16384 }, { 0, 1, 2 } });
+}
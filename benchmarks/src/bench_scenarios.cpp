@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.h"
+#include "Level.h"
+#include "MapGenerator.h"
+
+#include "Core/Headless/SimulationHost.h"
+#include "Core/LayerStack.h"
+
+namespace {
+
+	constexpr uint32_t SCENARIO_TICKS = 600;
+
+	// Time per level tick on a generated map, range(0) picks the scenario and
+	// range(1) the area scale, so each scenario reads as a curve over map size
+	void BM_ScenarioTick(benchmark::State& state)
+	{
+		const MapScenario& scenario = GetMapScenarios().at(static_cast<size_t>(state.range(0)));
+		const uint32_t areaScale = static_cast<uint32_t>(state.range(1));
+
+		LevelOptions levelOptions;
+		levelOptions.mIsHeadless = true;
+		levelOptions.mPathfindingWorkers = 0;
+		levelOptions.mAutosaveFile.clear();
+		levelOptions.mMapId = PrepareScenarioMap(scenario, areaScale);
+
+		SimulationHostConfig hostConfig;
+		hostConfig.mThreadCount = 1;
+		hostConfig.mTicksPerInstance = SCENARIO_TICKS;
+		hostConfig.mWarmupTicks = 0;
+
+		uint32_t spriteCount = 0;
+		for (auto _ : state)
+		{
+			// Level creation happens outside the host's tick timer
+			SimulationHost host(hostConfig, [&levelOptions](uint32_t instance) {
+				return std::make_unique<Level>(levelOptions);
+			});
+			host.SetSummarizer([&spriteCount](ILayer& layer) {
+				spriteCount = static_cast<Level&>(layer).GetStats().mSpriteCount;
+				return std::string();
+			});
+
+			const SimulationInstanceReport instance = host.Run().mInstances.front();
+			state.SetIterationTime(instance.mSeconds / instance.mTicks);
+		}
+
+		TiledMap& map = GetGameAssets().GetAsset<TiledMap>(levelOptions.mMapId);
+		state.counters["tiles"] = static_cast<double>(map.GetTileCount());
+		state.counters["sprites"] = spriteCount;
+		state.counters["map_bytes"] = static_cast<double>(map.GetMemoryUsage().GetTotalBytes());
+		state.SetLabel(scenario.mName);
+	}
+	BENCHMARK(BM_ScenarioTick)
+		->ArgsProduct({ benchmark::CreateDenseRange(0, static_cast<int64_t>(GetMapScenarios().size()) - 1, 1), { 1, 4, 16, 64 } })
+		->UseManualTime()
+		->Iterations(3)
+		->Unit(benchmark::kMicrosecond);
+
+	// Level::Create alone on the same maps, spawning is bound by the object count
+	void BM_ScenarioLevelCreate(benchmark::State& state)
+	{
+		const MapScenario& scenario = GetMapScenarios().at(static_cast<size_t>(state.range(0)));
+		const uint32_t areaScale = static_cast<uint32_t>(state.range(1));
+
+		LevelOptions levelOptions;
+		levelOptions.mIsHeadless = true;
+		levelOptions.mPathfindingWorkers = 0;
+		levelOptions.mAutosaveFile.clear();
+		levelOptions.mMapId = PrepareScenarioMap(scenario, areaScale);
+
+		uint32_t spriteCount = 0;
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			auto layerStack = std::make_unique<LayerStack>();
+			auto level = std::make_unique<Level>(levelOptions);
+			Level& levelRef = *level;
+			level->SetLayerStack(layerStack.get());
+			state.ResumeTiming();
+
+			// The first layer is created as it is pushed, the post update flushes its groups
+			layerStack->PushLayer(std::move(level));
+			layerStack->PostUpdate();
+
+			state.PauseTiming();
+			spriteCount = levelRef.GetStats().mSpriteCount;
+			layerStack.reset();
+			state.ResumeTiming();
+		}
+		state.counters["sprites"] = spriteCount;
+		state.SetLabel(scenario.mName);
+	}
+	BENCHMARK(BM_ScenarioLevelCreate)
+		->ArgsProduct({ benchmark::CreateDenseRange(0, static_cast<int64_t>(GetMapScenarios().size()) - 1, 1), { 1, 4, 16, 64 } })
+		->Iterations(3)
+		->Unit(benchmark::kMillisecond);
+
+	// Rollback on a generated map, restoring snapshots taken one tick apart so
+	// the soil and trees match and only the moving parts differ
+	void BM_ScenarioRestoreNearIdenticalSnapshot(benchmark::State& state)
+	{
+		const MapScenario& scenario = GetMapScenarios().at(static_cast<size_t>(state.range(0)));
+		const uint32_t areaScale = static_cast<uint32_t>(state.range(1));
+
+		LevelOptions levelOptions;
+		levelOptions.mIsHeadless = true;
+		levelOptions.mPathfindingWorkers = 0;
+		levelOptions.mAutosaveFile.clear();
+		levelOptions.mMapId = PrepareScenarioMap(scenario, areaScale);
+
+		SeedRandom(1);
+		LayerStack layerStack;
+		auto level = std::make_unique<Level>(levelOptions);
+		Level& levelRef = *level;
+		level->SetLayerStack(&layerStack);
+		layerStack.PushLayer(std::move(level));
+
+		const sf::Time timestep = sf::seconds(1.0f / 60.0f);
+		for (uint32_t tick = 0; tick < 60; tick++)
+		{
+			layerStack.Update(timestep);
+			layerStack.PostUpdate();
+		}
+
+		std::vector<uint8_t> before;
+		levelRef.SaveSnapshot(before);
+		layerStack.Update(timestep);
+		layerStack.PostUpdate();
+		std::vector<uint8_t> after;
+		levelRef.SaveSnapshot(after);
+
+		for (auto _ : state)
+		{
+			levelRef.RestoreSnapshot(before);
+			layerStack.PostUpdate();
+			levelRef.RestoreSnapshot(after);
+			layerStack.PostUpdate();
+		}
+		state.SetItemsProcessed(state.iterations() * 2);
+		state.counters["sprites"] = levelRef.GetStats().mSpriteCount;
+		state.SetLabel(scenario.mName);
+	}
+	BENCHMARK(BM_ScenarioRestoreNearIdenticalSnapshot)
+		->ArgsProduct({ benchmark::CreateDenseRange(0, static_cast<int64_t>(GetMapScenarios().size()) - 1, 1), { 1, 4 } })
+		->Unit(benchmark::kMicrosecond);
+}
@@ -0,0 +1,169 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.h"
+#include "Level.h"
+
+#include <cmath>
+
+namespace {
+
+	void BM_GroupAdd(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		std::unique_ptr<Scene> scene;
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			scene = std::make_unique<Scene>();
+			Group* group = scene->CreateGroup();
+			std::vector<GameObject*> sprites = CreateSprites(*scene, count);
+			state.ResumeTiming();
+
+			for (GameObject* sprite : sprites)
+			{
+				group->Add(sprite);
+			}
+			group->Update();
+			benchmark::DoNotOptimize(group->GetSize());
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+	BENCHMARK(BM_GroupAdd)->RangeMultiplier(4)->Range(256, 16384);
+
+	void BM_GroupRemove(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		std::unique_ptr<Scene> scene;
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			scene = std::make_unique<Scene>();
+			Group* group = scene->CreateGroup();
+			std::vector<GameObject*> sprites = CreateSprites(*scene, count);
+			for (GameObject* sprite : sprites)
+			{
+				group->Add(sprite);
+			}
+			group->Update();
+			state.ResumeTiming();
+
+			// A tenth of the group, as a frame of harvesting would
+			for (size_t index = 0; index < count; index += 10)
+			{
+				group->Remove(sprites[index]);
+			}
+			benchmark::DoNotOptimize(group->GetSize());
+		}
+		state.SetItemsProcessed(state.iterations() * (count / 10));
+	}
+	BENCHMARK(BM_GroupRemove)->RangeMultiplier(4)->Range(256, 16384);
+
+	void BM_GroupIterate(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		Scene scene;
+		Group* group = scene.CreateGroup();
+		SpawnSprites(scene, *group, count);
+
+		for (auto _ : state)
+		{
+			float sum = 0.0f;
+			for (GameObject* gameObject : *group)
+			{
+				sum += static_cast<Sprite*>(gameObject)->GetPosition().y;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+	BENCHMARK(BM_GroupIterate)->RangeMultiplier(4)->Range(256, 16384);
+
+	void BM_SceneCreateKillChurn(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		Scene scene;
+		Group* group = scene.CreateGroup();
+		SpawnSprites(scene, *group, count);
+
+		// Replaces a tenth of the population per frame, like particles and drops
+		const size_t churn = count / 10;
+		for (auto _ : state)
+		{
+			size_t killed = 0;
+			for (GameObject* gameObject : *group)
+			{
+				if (killed++ == churn)
+				{
+					break;
+				}
+				gameObject->Kill();
+			}
+
+			for (GameObject* sprite : CreateSprites(scene, churn))
+			{
+				group->Add(sprite);
+			}
+			scene.PostUpdate();
+		}
+		state.SetItemsProcessed(state.iterations() * churn);
+	}
+	BENCHMARK(BM_SceneCreateKillChurn)->RangeMultiplier(4)->Range(256, 16384);
+
+	void BM_LevelYSort(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		Scene scene;
+		Group* group = scene.CreateGroup();
+		std::vector<GameObject*> sprites = CreateSprites(scene, count);
+		for (GameObject* sprite : sprites)
+		{
+			group->Add(sprite);
+		}
+		scene.PostUpdate();
+
+		SeedRandom(2);
+		for (auto _ : state)
+		{
+			// Move a tenth of the sprites, so each pass sorts a mostly sorted frame
+			state.PauseTiming();
+			for (size_t index = 0; index < count / 10; index++)
+			{
+				Sprite* sprite = static_cast<Sprite*>(GetRandomElement(sprites));
+				sprite->MoveY(static_cast<float>(RandomInteger(-64, 64)));
+			}
+			state.ResumeTiming();
+
+			group->Sort(Level::SpriteCompareFunc);
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+	BENCHMARK(BM_LevelYSort)->RangeMultiplier(4)->Range(256, 16384);
+
+	// Map area grows with the population at constant density, the camera stays put
+	void BM_SceneScheduledUpdate(benchmark::State& state)
+	{
+		const size_t count = static_cast<size_t>(state.range(0));
+		const float side = std::sqrt(static_cast<float>(count)) * 64.0f;
+
+		Scene scene;
+		Group* group = scene.CreateGroup();
+		scene.ScheduleUpdates(group);
+		for (GameObject* gameObject : CreateSprites(scene, count))
+		{
+			Sprite* sprite = static_cast<Sprite*>(gameObject);
+			sprite->SetPosition(sf::Vector2f(sprite->GetPosition().x / 3200.0f * side, sprite->GetPosition().y / 2560.0f * side));
+			group->Add(sprite);
+		}
+		scene.PostUpdate();
+		scene.GetUpdateScheduler().SetFocus(sf::Vector2f(640.0f, 360.0f));
+
+		size_t updated = 0;
+		for (auto _ : state)
+		{
+			scene.UpdateScheduledObjects(sf::seconds(1.0f / 60.0f));
+			updated += scene.GetUpdateScheduler().GetLastUpdateCount();
+		}
+		state.counters["updated"] = benchmark::Counter(static_cast<double>(updated), benchmark::Counter::kAvgIterations);
+	}
+	BENCHMARK(BM_SceneScheduledUpdate)->RangeMultiplier(4)->Range(1024, 262144);
+}
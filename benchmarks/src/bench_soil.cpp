@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.h"
+#include "SoilLayer.h"
+
+namespace {
+
+	// The "main" map has 376 farmable tiles, the huge farm at 4x area over 3000,
+	// so every range below is backed by real tiles
+	TiledMap& GetFarmMap()
+	{
+		static const std::string& mapId = PrepareScenarioMap(*FindMapScenario("huge-farm"), 4);
+		return GetGameAssets().GetAsset<TiledMap>(mapId);
+	}
+
+	// Centres of maxCount farmable tiles, in row order
+	std::vector<sf::Vector2f> GetFarmablePoints(benchmark::State& state, size_t maxCount)
+	{
+		TiledMap& map = GetFarmMap();
+		const sf::Vector2f halfTile = map.GetTileSize() / 2.0f;
+
+		std::vector<sf::Vector2f> points;
+		for (const auto& pair : map.GetLayerByName("Farmable")->getTileObjects())
+		{
+			const tson::Vector2f position = pair.second.getPosition();
+			points.emplace_back(position.x + halfTile.x, position.y + halfTile.y);
+		}
+		std::sort(points.begin(), points.end(), [](const sf::Vector2f& a, const sf::Vector2f& b) {
+			return a.y != b.y ? a.y < b.y : a.x < b.x;
+		});
+		if (points.size() < maxCount)
+		{
+			state.SkipWithError("Not enough farmable tiles for the range");
+		}
+		points.resize(std::min(points.size(), maxCount));
+		return points;
+	}
+
+	struct SoilFixture
+	{
+		SoilFixture()
+			: mAllSprites(*mScene.CreateGroup())
+			, mSoilLayer(mAllSprites, mScene, GetFarmMap())
+		{ }
+
+		Scene mScene;
+		Group& mAllSprites;
+		SoilLayer mSoilLayer;
+	};
+
+	void BM_SoilHoe(benchmark::State& state)
+	{
+		const std::vector<sf::Vector2f> points = GetFarmablePoints(state, static_cast<size_t>(state.range(0)));
+		std::unique_ptr<SoilFixture> fixture;
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			fixture = std::make_unique<SoilFixture>();
+			state.ResumeTiming();
+
+			// One hoe per frame, each one rebuilds the soil sprites
+			for (const sf::Vector2f& point : points)
+			{
+				fixture->mSoilLayer.HoeSoil(point);
+				fixture->mScene.PostUpdate();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * points.size());
+		state.counters["tiles"] = static_cast<double>(points.size());
+	}
+	BENCHMARK(BM_SoilHoe)->RangeMultiplier(4)->Range(16, 1024)->Unit(benchmark::kMillisecond);
+
+	void BM_SoilWaterAll(benchmark::State& state)
+	{
+		const std::vector<sf::Vector2f> points = GetFarmablePoints(state, static_cast<size_t>(state.range(0)));
+		SoilFixture fixture;
+		for (const sf::Vector2f& point : points)
+		{
+			fixture.mSoilLayer.HoeSoil(point);
+		}
+		fixture.mScene.PostUpdate();
+
+		for (auto _ : state)
+		{
+			fixture.mSoilLayer.WaterAll();
+			fixture.mScene.PostUpdate();
+
+			state.PauseTiming();
+			fixture.mSoilLayer.RemoveAllWaterSoilTiles();
+			fixture.mScene.PostUpdate();
+			state.ResumeTiming();
+		}
+		state.SetItemsProcessed(state.iterations() * points.size());
+		state.counters["tiles"] = static_cast<double>(points.size());
+	}
+	BENCHMARK(BM_SoilWaterAll)->RangeMultiplier(4)->Range(16, 1024);
+
+	// Rollback between two snapshots a few hoed and watered tiles apart, over
+	// range(0) hoed tiles, only the differing cells should touch their sprites
+	void BM_SoilRestoreNearIdentical(benchmark::State& state)
+	{
+		const std::vector<sf::Vector2f> points = GetFarmablePoints(state, static_cast<size_t>(state.range(0)) + 4);
+		SoilFixture fixture;
+		for (size_t index = 0; index + 4 < points.size(); index++)
+		{
+			fixture.mSoilLayer.HoeSoil(points[index]);
+		}
+		fixture.mSoilLayer.WaterAll();
+
+		std::vector<uint8_t> before;
+		BinaryWriter beforeWriter(before);
+		fixture.mSoilLayer.SaveState(beforeWriter);
+
+		for (size_t index = points.size() - 4; index < points.size(); index++)
+		{
+			fixture.mSoilLayer.HoeSoil(points[index]);
+			fixture.mSoilLayer.WaterSoil(points[index]);
+		}
+		std::vector<uint8_t> after;
+		BinaryWriter afterWriter(after);
+		fixture.mSoilLayer.SaveState(afterWriter);
+		fixture.mScene.PostUpdate();
+
+		for (auto _ : state)
+		{
+			BinaryReader beforeReader(before);
+			fixture.mSoilLayer.RestoreState(beforeReader);
+			fixture.mScene.PostUpdate();
+
+			BinaryReader afterReader(after);
+			fixture.mSoilLayer.RestoreState(afterReader);
+			fixture.mScene.PostUpdate();
+		}
+		state.SetItemsProcessed(state.iterations() * 2);
+		state.counters["tiles"] = static_cast<double>(points.size());
+	}
+	BENCHMARK(BM_SoilRestoreNearIdentical)->RangeMultiplier(4)->Range(16, 1024);
+}
@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.h"
+
+#include <stdexcept>
+
+namespace {
+
+	// Draws every visible tile layer of the whole map into an offscreen target
+	void BM_TiledMapDrawTileLayers(benchmark::State& state)
+	{
+		TiledMap& map = GetGameAssets().GetAsset<TiledMap>("main");
+		const sf::Vector2f mapSize = map.GetMapSize();
+		const sf::Vector2u targetSize(static_cast<uint32_t>(state.range(0)), static_cast<uint32_t>(state.range(1)));
+
+		sf::RenderTexture target;
+		if (!target.create(targetSize))
+		{
+			throw std::runtime_error("Unable to create benchmark render texture");
+		}
+
+		const sf::FloatRect viewBounds(sf::Vector2f(), mapSize);
+		target.setView(sf::View(viewBounds));
+		const ViewRegion viewRegion(map.GetTileSize(), mapSize, viewBounds);
+
+		std::vector<size_t> tileLayers;
+		for (size_t layerIndex = 0; layerIndex < map.LayerCount(); layerIndex++)
+		{
+			if (map.GetLayerType(layerIndex) == LayerType::TileLayer)
+			{
+				tileLayers.push_back(layerIndex);
+			}
+		}
+
+		for (auto _ : state)
+		{
+			target.clear();
+			for (size_t layerIndex : tileLayers)
+			{
+				map.DrawLayer(layerIndex, target, viewRegion);
+			}
+			target.display();
+		}
+		state.counters["layers"] = static_cast<double>(tileLayers.size());
+	}
+	BENCHMARK(BM_TiledMapDrawTileLayers)->Args({ 1280, 720 })->Args({ 3200, 2560 })->Unit(benchmark::kMillisecond);
+}
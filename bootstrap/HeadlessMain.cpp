@@ -0,0 +1,182 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "Core/Headless/SimulationHost.h"
+#include "Core/Input/InputSource.h"
+#include "Core/ResourceLocator.h"
+#include "GameAssets.h"
+#include "Level.h"
+#include "MapGenerator.h"
+#include "Settings.h"
+
+// Simulates many farms without a window, e.g.
+//   PydewValleyHeadless --farms 32 --ticks 36000 --threads 8 --replay session.rec
+// --allocation-budget 0 fails the run if any farm touches the heap after --warmup ticks
+// --scenario dense-forest --scales 1,4,16 generates the scenario at each area scale
+// and reports frame time and map memory as a curve over map size
+int main(int argc, char** argv)
+{
+	SimulationHostConfig hostConfig;
+	hostConfig.mInstanceCount = 8;
+	hostConfig.mTicksPerInstance = 60 * 60;
+	std::string replayPath;
+	int64_t allocationBudget = -1;
+	const MapScenario* scenario = nullptr;
+	std::vector<uint32_t> scales = { 1 };
+
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--farms") == 0)
+		{
+			hostConfig.mInstanceCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0)
+		{
+			hostConfig.mThreadCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--ticks") == 0)
+		{
+			hostConfig.mTicksPerInstance = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0)
+		{
+			hostConfig.mSeed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--replay") == 0)
+		{
+			replayPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--warmup") == 0)
+		{
+			hostConfig.mWarmupTicks = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (std::strcmp(argv[i], "--allocation-budget") == 0)
+		{
+			allocationBudget = std::strtoll(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--scenario") == 0)
+		{
+			scenario = FindMapScenario(argv[++i]);
+			if (!scenario)
+			{
+				std::cerr << "Unknown scenario " << argv[i] << std::endl;
+				return EXIT_FAILURE;
+			}
+		}
+		else if (std::strcmp(argv[i], "--scales") == 0)
+		{
+			scales.clear();
+			std::istringstream list(argv[++i]);
+			for (std::string scale; std::getline(list, scale, ',');)
+			{
+				scales.push_back(static_cast<uint32_t>(std::strtoul(scale.c_str(), nullptr, 10)));
+			}
+		}
+	}
+
+	// Farm 0 starts from the recorded seed and reproduces the recorded session
+	if (!replayPath.empty())
+	{
+		hostConfig.mSeed = LoadInputRecording(replayPath).mSeed;
+	}
+
+	// One immutable asset store shared by every farm
+	ResourceLocator& locator = ResourceLocator::GetInstance();
+	locator.Initialize(ApplicationConfig{ WIDTH, HEIGHT, 32, CAPTION });
+	AssetManager& assetManager = locator.GetAssetManager();
+	RegisterGameAssets(assetManager, AssetLoadPolicy::Eager);
+
+	// Generated maps must be registered before the store is frozen
+	std::vector<std::string> mapIds = { "main" };
+	if (scenario)
+	{
+		mapIds.clear();
+		for (uint32_t scale : scales)
+		{
+			mapIds.push_back(GetScenarioMapId(*scenario, scale));
+			assetManager.RegisterAssetFile<TiledMap>(mapIds.back(), GenerateScenarioMap(*scenario, scale));
+		}
+		assetManager.ProcessAssetQueue();
+	}
+	assetManager.Freeze();
+	assetManager.WriteMemoryReport(std::cout);
+
+	// Path queries are solved on the farm's own thread, the pool already uses every core
+	LevelOptions levelOptions;
+	levelOptions.mIsHeadless = true;
+	levelOptions.mPathfindingWorkers = 0;
+	levelOptions.mAutosaveFile.clear();
+
+	std::atomic<uint32_t> spriteCount{ 0 };
+	auto summarize = [&spriteCount](ILayer& layer) {
+		const LevelStats stats = static_cast<Level&>(layer).GetStats();
+		spriteCount = stats.mSpriteCount;
+		std::ostringstream summary;
+		summary << "days " << stats.mDaysCompleted << "  trees " << stats.mTreesStanding;
+		for (const auto& [item, count] : stats.mInventory)
+		{
+			summary << "  " << item << " " << count;
+		}
+		return summary.str();
+	};
+
+	std::ostringstream curve;
+	curve << "scale  tiles  sprites  ms/tick  map KiB" << std::endl;
+	for (size_t run = 0; run < mapIds.size(); run++)
+	{
+		levelOptions.mMapId = mapIds[run];
+		SimulationHost host(hostConfig, [&levelOptions](uint32_t instance) {
+			return std::make_unique<Level>(levelOptions);
+		});
+		if (!replayPath.empty())
+		{
+			host.SetInputFactory([&replayPath](uint32_t instance) {
+				return std::make_unique<ReplayInputSource>(replayPath);
+			});
+		}
+		host.SetSummarizer(summarize);
+
+		std::cout << "map " << mapIds[run] << std::endl;
+		const SimulationReport report = host.Run();
+		SimulationHost::WriteReport(std::cout, report);
+
+		if (allocationBudget >= 0)
+		{
+			for (const SimulationInstanceReport& instance : report.mInstances)
+			{
+				if (instance.mSteadyAllocations > static_cast<uint64_t>(allocationBudget))
+				{
+					std::cerr << "instance " << instance.mInstance << " made " << instance.mSteadyAllocations
+							  << " heap allocations after warmup, budget " << allocationBudget << std::endl;
+					return EXIT_FAILURE;
+				}
+			}
+		}
+
+		// Per farm tick cost, independent of how many workers shared the load
+		double instanceSeconds = 0.0;
+		for (const SimulationInstanceReport& instance : report.mInstances)
+		{
+			instanceSeconds += instance.mSeconds;
+		}
+		TiledMap& map = assetManager.GetAsset<TiledMap>(mapIds[run]);
+		curve << std::left << std::setw(7) << (scenario ? scales[run] : 1)
+			  << std::setw(7) << map.GetTileCount()
+			  << std::setw(9) << spriteCount.load()
+			  << std::setw(9) << std::fixed << std::setprecision(3)
+			  << (report.mTotalTicks > 0 ? instanceSeconds * 1000.0 / report.mTotalTicks : 0.0)
+			  << map.GetMemoryUsage().GetTotalBytes() / 1024 << std::endl;
+	}
+
+	if (scenario)
+	{
+		std::cout << "scenario " << scenario->mName << std::endl << curve.str();
+	}
+	return EXIT_SUCCESS;
+}
@@ -1,4 +1,7 @@
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <random>
 
 #include "Core/Application.h"
 #include "Settings.h"
@@ -7,6 +10,27 @@ extern std::unique_ptr<IApplicationListener> CreateApplication();
 
 int main(int argc, char** argv)
 {
-	Application app(CreateApplication(), { WIDTH, HEIGHT, 32, CAPTION });
+	ApplicationConfig config{ WIDTH, HEIGHT, 32, CAPTION };
+	config.mSeed = std::random_device()();
+
+	// --record <file> captures the session's input and seed, --replay <file> plays it back,
+	// --seed <n> starts a session from a known seed
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--record") == 0)
+		{
+			config.mRecordInputPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--replay") == 0)
+		{
+			config.mReplayInputPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0)
+		{
+			config.mSeed = std::strtoull(argv[++i], nullptr, 10);
+		}
+	}
+
+	Application app(CreateApplication(), config);
 	app.Run();
-}
\ No newline at end of file
+}
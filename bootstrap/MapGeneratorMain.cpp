@@ -0,0 +1,83 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "MapGenerator.h"
+
+// Writes a Tiled map for stress testing, e.g.
+//   PydewValleyMapGenerator --scenario dense-forest --scale 16 --output forest.json
+// Any other option overrides the scenario: --width --height --seed --layers
+// --trees --flowers --collision --water --farmable --rain. --list prints the scenarios.
+int main(int argc, char** argv)
+{
+	const MapScenario* scenario = FindMapScenario("baseline");
+	uint32_t areaScale = 1;
+	std::string outputPath;
+
+	// The scenario and scale apply before the overrides, wherever they appear
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--list") == 0)
+		{
+			for (const MapScenario& entry : GetMapScenarios())
+			{
+				std::cout << entry.mName << "  " << entry.mDescription << std::endl;
+			}
+			return EXIT_SUCCESS;
+		}
+		else if (std::strcmp(argv[i], "--scenario") == 0 && i + 1 < argc)
+		{
+			scenario = FindMapScenario(argv[++i]);
+			if (!scenario)
+			{
+				std::cerr << "Unknown scenario " << argv[i] << ", see --list" << std::endl;
+				return EXIT_FAILURE;
+			}
+		}
+		else if (std::strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+		{
+			areaScale = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		}
+	}
+
+	MapGeneratorConfig config = ScaleMapConfig(scenario->mConfig, areaScale);
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		const char* value = argv[i + 1];
+		if (std::strcmp(argv[i], "--output") == 0) { outputPath = value; }
+		else if (std::strcmp(argv[i], "--width") == 0) { config.mWidth = static_cast<uint32_t>(std::strtoul(value, nullptr, 10)); }
+		else if (std::strcmp(argv[i], "--height") == 0) { config.mHeight = static_cast<uint32_t>(std::strtoul(value, nullptr, 10)); }
+		else if (std::strcmp(argv[i], "--seed") == 0) { config.mSeed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10)); }
+		else if (std::strcmp(argv[i], "--layers") == 0) { config.mDetailLayerCount = static_cast<uint32_t>(std::strtoul(value, nullptr, 10)); }
+		else if (std::strcmp(argv[i], "--trees") == 0) { config.mTreeDensity = std::strtof(value, nullptr); }
+		else if (std::strcmp(argv[i], "--flowers") == 0) { config.mFlowerDensity = std::strtof(value, nullptr); }
+		else if (std::strcmp(argv[i], "--collision") == 0) { config.mCollisionFraction = std::strtof(value, nullptr); }
+		else if (std::strcmp(argv[i], "--water") == 0) { config.mWaterFraction = std::strtof(value, nullptr); }
+		else if (std::strcmp(argv[i], "--farmable") == 0) { config.mFarmableFraction = std::strtof(value, nullptr); }
+		else if (std::strcmp(argv[i], "--rain") == 0) { config.mRainChance = static_cast<int32_t>(std::strtol(value, nullptr, 10)); }
+		else { continue; }
+		++i;
+	}
+
+	if (outputPath.empty())
+	{
+		outputPath = std::string(GENERATED_MAP_DIRECTORY) + "/" + scenario->mName + "_x" + std::to_string(areaScale) + ".json";
+	}
+
+	try
+	{
+		const GeneratedMapStats stats = GenerateMap(config, outputPath);
+		std::cout << outputPath << ": " << config.mWidth << "x" << config.mHeight << " tiles, "
+				  << stats.mLayerCount << " layers, " << stats.mTreeCount << " trees, "
+				  << stats.mFlowerCount << " flowers, " << stats.mWaterTiles << " water, "
+				  << stats.mCollisionTiles << " collision, " << stats.mFarmableTiles << " farmable" << std::endl;
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << exception.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
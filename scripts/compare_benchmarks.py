@@ -0,0 +1,85 @@
+"""Compares two Google Benchmark JSON reports and flags regressions.
+
+Record a baseline and a candidate from the build directory, e.g.
+    PydewValleyBenchmarks --benchmark_repetitions=5 --benchmark_out=baseline.json
+    PydewValleyBenchmarks --benchmark_repetitions=5 --benchmark_out=candidate.json
+    python compare_benchmarks.py baseline.json candidate.json --threshold 5
+
+Exits with status 1 when any benchmark is slower than the threshold allows.
+"""
+import argparse
+import json
+import sys
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_times(filepath, metric):
+    """Returns {benchmark name: time in ns}, preferring the median of repetitions."""
+    with open(filepath, "r") as report_file:
+        report = json.load(report_file)
+
+    medians = {}
+    samples = {}
+    for benchmark in report.get("benchmarks", []):
+        if benchmark.get("error_occurred"):
+            continue
+
+        name = benchmark.get("run_name", benchmark["name"])
+        time = benchmark[metric] * TIME_UNITS[benchmark.get("time_unit", "ns")]
+        if benchmark.get("run_type") == "aggregate":
+            if benchmark.get("aggregate_name") == "median":
+                medians[name] = time
+        else:
+            samples.setdefault(name, []).append(time)
+
+    times = {name: sum(values) / len(values) for name, values in samples.items()}
+    times.update(medians)
+    return times
+
+
+def format_time(time_ns):
+    for unit in ("s", "ms", "us"):
+        if time_ns >= TIME_UNITS[unit]:
+            return f"{time_ns / TIME_UNITS[unit]:.3f} {unit}"
+    return f"{time_ns:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="benchmark JSON recorded before the change")
+    parser.add_argument("candidate", help="benchmark JSON recorded after the change")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent (default 10)")
+    parser.add_argument("--metric", choices=("cpu_time", "real_time"), default="cpu_time")
+    args = parser.parse_args()
+
+    baseline = load_times(args.baseline, args.metric)
+    candidate = load_times(args.candidate, args.metric)
+
+    regressions = []
+    name_width = max((len(name) for name in candidate), default=10)
+    print(f"{'Benchmark':<{name_width}}  {'Baseline':>12}  {'Candidate':>12}  {'Change':>8}")
+    for name, time in candidate.items():
+        if name not in baseline:
+            print(f"{name:<{name_width}}  {'-':>12}  {format_time(time):>12}  {'new':>8}")
+            continue
+
+        change = (time - baseline[name]) / baseline[name] * 100.0
+        flag = ""
+        if change > args.threshold:
+            regressions.append(name)
+            flag = "  REGRESSION"
+        print(f"{name:<{name_width}}  {format_time(baseline[name]):>12}  {format_time(time):>12}  {change:>+7.1f}%{flag}")
+
+    for name in baseline:
+        if name not in candidate:
+            print(f"{name:<{name_width}}  {format_time(baseline[name]):>12}  {'-':>12}  {'missing':>8}")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) regressed by more than {args.threshold:g}%")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
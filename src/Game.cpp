@@ -2,13 +2,10 @@
 
 #include "Core/IApplicationListener.h"
 #include "Core/AssetManager.h"
-#include "Core/Texture.h"
-#include "Core/Animation/Animation.h"
-#include "Core/Shader.h"
-#include "Core/Spritesheet.h"
-#include "Core/Tiled/TiledMap.h"
 #include "Core/ILayer.h"
+#include "Core/Input/InputSystem.h"
 
+#include "GameAssets.h"
 #include "Level.h"
 
 class Game : public ILayer
@@ -18,19 +15,30 @@ public:
 	{
 		AssetManager& assetManager = GetResourceLocator().GetAssetManager();
 
-		// Register Loaders
-		assetManager.RegisterLoader<TiledMap>(std::make_unique<TiledMapLoader>());
-		assetManager.RegisterLoader<Shader>(std::make_unique<ShaderLoader>());
-
-		// Load descriptors
-		assetManager.LoadAssetsFromManifest<Texture>("../../config/textures.cfg");
-		assetManager.LoadAssetsFromManifest<Spritesheet>("../../config/spritesheet.cfg");
-		assetManager.LoadAssetsFromManifest<Animation>("../../config/animations.cfg");
-		assetManager.LoadAssetsFromManifest<TiledMap>("../../config/maps.cfg");
-		assetManager.LoadAssetsFromManifest<Shader>("../../config/shaders.cfg");
-		assetManager.ProcessAssetQueue();
-
-		PushLayer(std::make_unique<Level>());
+		// Textures decode on first use, the rest is needed to start a level
+		RegisterGameAssets(assetManager, AssetLoadPolicy::Lazy);
+		assetManager.SetMemoryBudget(ASSET_MEMORY_BUDGET);
+
+		// Input bindings
+		auto keyboard = std::make_unique<KeyboardInputSource>();
+		keyboard->Bind(Action::MOVE_UP, sf::Keyboard::Key::Up);
+		keyboard->Bind(Action::MOVE_DOWN, sf::Keyboard::Key::Down);
+		keyboard->Bind(Action::MOVE_LEFT, sf::Keyboard::Key::Left);
+		keyboard->Bind(Action::MOVE_RIGHT, sf::Keyboard::Key::Right);
+		keyboard->Bind(Action::USE_TOOL, sf::Keyboard::Key::Space);
+		keyboard->Bind(Action::SWITCH_TOOL, sf::Keyboard::Key::Q);
+		keyboard->Bind(Action::USE_SEED, sf::Keyboard::Key::LControl);
+		keyboard->Bind(Action::SWITCH_SEED, sf::Keyboard::Key::E);
+		keyboard->Bind(Action::SLEEP, sf::Keyboard::Key::Enter);
+		GetInput().SetSource(std::move(keyboard));
+
+		// Worker results land on whichever tick they finish, which a replay cannot reproduce
+		LevelOptions levelOptions;
+		if (GetResourceLocator().GetApplicationConfig().IsDeterministic())
+		{
+			levelOptions.mPathfindingWorkers = 0;
+		}
+		PushLayer(std::make_unique<Level>(levelOptions));
 	}
 
 private:
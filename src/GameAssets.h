@@ -0,0 +1,40 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Core
+#include "Core/AssetManager.h"
+#include "Core/Audio/SoundSample.h"
+#include "Core/Texture.h"
+#include "Core/Font.h"
+#include "Core/Animation/Animation.h"
+#include "Core/Shader.h"
+#include "Core/Spritesheet.h"
+#include "Core/Tiled/TiledMap.h"
+
+//------------------------------------------------------------------------------
+// Registers the game's loaders and manifests, shared by the windowed game and
+// the headless host
+inline void RegisterGameAssets(AssetManager& assetManager, AssetLoadPolicy texturePolicy)
+{
+	// Register Loaders
+	assetManager.RegisterLoader<TiledMap>(std::make_unique<TiledMapLoader>(TiledJsonBackend::OnDemand), "TiledMap");
+	assetManager.RegisterLoader<Shader>(std::make_unique<ShaderLoader>(), "Shader");
+	assetManager.RegisterLoader<SoundSample>(std::make_unique<SoundSampleLoader>(), "SoundSample");
+	assetManager.RegisterLoader<MusicTrack>(std::make_unique<MusicTrackLoader>(), "MusicTrack");
+	assetManager.SetLoadPolicy<Texture>(texturePolicy);
+
+	// Load descriptors
+	assetManager.LoadAssetsFromManifest<Texture>("../../config/textures.cfg");
+	assetManager.LoadAssetsFromManifest<Spritesheet>("../../config/spritesheet.cfg");
+	assetManager.LoadAssetsFromManifest<Animation>("../../config/animations.cfg");
+	assetManager.LoadAssetsFromManifest<TiledMap>("../../config/maps.cfg");
+	assetManager.LoadAssetsFromManifest<Shader>("../../config/shaders.cfg");
+	assetManager.LoadAssetsFromManifest<SoundSample>("../../config/sounds.cfg");
+	assetManager.LoadAssetsFromManifest<MusicTrack>("../../config/music.cfg");
+	assetManager.RegisterAssetFile<Font>("hud", "../../font/LycheeSoda.ttf");
+
+	// The file name has a comma, which the manifest format cannot hold
+	assetManager.RegisterAssetFile<Font>("debug", "../../graphics/fonts/Inter/Inter-VariableFont_slnt,wght.ttf");
+	assetManager.ProcessAssetQueue();
+}
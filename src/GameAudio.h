@@ -0,0 +1,70 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Core
+#include "Core/AssetManager.h"
+#include "Core/Audio/AudioSystem.h"
+#include "Core/Audio/SoundSample.h"
+
+// System
+#include <string>
+
+//------------------------------------------------------------------------------
+// Maps game events to sounds. Assets are acquired once here so playing is a
+// queue push on the audio system, with no lookups or allocation.
+class GameAudio
+{
+public:
+	GameAudio(AudioSystem& audio, AssetManager& assetManager)
+		: mAudio(audio)
+		, mAxe(assetManager.AcquireAsset<SoundSample>("axe"))
+		, mHoe(assetManager.AcquireAsset<SoundSample>("hoe"))
+		, mWater(assetManager.AcquireAsset<SoundSample>("water"))
+		, mPlant(assetManager.AcquireAsset<SoundSample>("plant"))
+		, mSuccess(assetManager.AcquireAsset<SoundSample>("success"))
+		, mMusic(assetManager.AcquireAsset<MusicTrack>("music"))
+		, mRainMusic(assetManager.AcquireAsset<MusicTrack>("bg"))
+	{
+		mAudio.SetMusicGain(0.5f);
+	}
+
+	~GameAudio()
+	{
+		mAudio.StopMusic();
+	}
+
+	void PlayTool(const std::string& tool)
+	{
+		if (tool == "axe") { mAudio.Play(*mAxe, { 0.3f }); }
+		else if (tool == "hoe") { mAudio.Play(*mHoe, { 0.1f }); }
+		else if (tool == "water") { mAudio.Play(*mWater, { 0.2f }); }
+	}
+
+	void PlayPlant() { mAudio.Play(*mPlant, { 0.2f }); }
+
+	// Item pickups are feedback the player waits on, so they outrank tool hits
+	void PlaySuccess() { mAudio.Play(*mSuccess, { 0.3f, 200 }); }
+
+	// Rainy days get the calmer background track, switched only on change
+	void SetWeather(bool isRaining)
+	{
+		const MusicTrack* track = isRaining ? &mRainMusic.Get() : &mMusic.Get();
+		if (track != mCurrentTrack)
+		{
+			mAudio.PlayMusic(*track);
+			mCurrentTrack = track;
+		}
+	}
+
+private:
+	AudioSystem& mAudio;
+	AssetHandle<SoundSample> mAxe;
+	AssetHandle<SoundSample> mHoe;
+	AssetHandle<SoundSample> mWater;
+	AssetHandle<SoundSample> mPlant;
+	AssetHandle<SoundSample> mSuccess;
+	AssetHandle<MusicTrack> mMusic;
+	AssetHandle<MusicTrack> mRainMusic;
+	const MusicTrack* mCurrentTrack{ nullptr };
+};
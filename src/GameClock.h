@@ -0,0 +1,35 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Game
+#include "Settings.h"
+
+// Third party
+#include <SFML/System.hpp>
+
+// System
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// Time of day, advanced by the simulation so it is saved and replayed with it
+class GameClock
+{
+public:
+	void Advance(const sf::Time& timestamp) { mElapsedSeconds += timestamp.asSeconds(); }
+	void StartDay() { mElapsedSeconds = 0.0f; }
+
+	// Minutes since midnight, wrapping past the end of the day
+	uint32_t GetMinuteOfDay() const
+	{
+		const uint32_t minutes = DAY_START_MINUTE + static_cast<uint32_t>(mElapsedSeconds * GAME_MINUTES_PER_SECOND);
+		return minutes % (24 * 60);
+	}
+
+	// Snapshot
+	float GetElapsedSeconds() const { return mElapsedSeconds; }
+	void SetElapsedSeconds(float seconds) { mElapsedSeconds = seconds; }
+
+private:
+	float mElapsedSeconds{ 0.0f };
+};
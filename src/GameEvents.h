@@ -0,0 +1,27 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// System
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+//------------------------------------------------------------------------------
+// Items something in the world can yield, named as the player's inventory keys them
+enum class InventoryItem : uint8_t
+{
+	Wood,
+	Apple,
+	Count
+};
+
+constexpr std::array<const char*, static_cast<size_t>(InventoryItem::Count)> INVENTORY_ITEM_NAMES = { "wood", "apple" };
+
+//------------------------------------------------------------------------------
+// Published on the level's event bus, a frame's worth is added to the inventory at once
+struct ItemCollectedEvent
+{
+	InventoryItem mItem;
+	uint8_t mCount;
+};
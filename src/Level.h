@@ -10,9 +10,28 @@
 #include "Core/Group.h"
 #include "Core/AssetManager.h"
 #include "Core/Tiled/TiledMap.h"
+#include "Core/Tiled/TiledMapChunkCache.h"
+#include "Core/BinaryStream.h"
+#include "Core/Collision/StaticCollisionMap.h"
+#include "Core/Collision/RectBatch.h"
+#include "Core/Navigation/NavGrid.h"
+#include "Core/Navigation/PathfindingService.h"
+#include "Core/Animation/AnimationFrameTable.h"
+#include "Core/Crowd/Crowd.h"
+#include "Core/Ecs/SpriteEntities.h"
+#include "Core/Events/EventBus.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/Render/RenderCommandList.h"
+#include "Core/Utils.h"
 
 #include <iostream>
+#include <future>
+#include <cstddef>
+#include <limits>
 #include "Overlay.h"
+#include "GameAudio.h"
+#include "GameClock.h"
+#include "GameEvents.h"
 #include "Sprites.h"
 #include "Tree.h"
 #include "Transition.h"
@@ -23,9 +42,11 @@
 class SceneLayerRenderer
 {
 public:
-	SceneLayerRenderer(TiledMap* tiledMap)
+	SceneLayerRenderer(TiledMap* tiledMap, bool flattenStaticLayers)
 		: mTiledMap(tiledMap)
 		, mExcludedLayers(tiledMap->LayerCount(), false)
+		, mChunkCache(*tiledMap)
+		, mFlattenStaticLayers(flattenStaticLayers)
 	{ }
 
 	void ExcludeLayerFromRendering(const std::string& layerName)
@@ -35,31 +56,152 @@ public:
 		mExcludedLayers[index.value()] = true;
 	}
 
-	void DrawLayer(size_t layerIndex, sf::RenderWindow& window, const ViewRegion& viewRegion)
+	void DrawLayer(size_t layerIndex, RenderCommandList& commands, const ViewRegion& viewRegion)
 	{
 		if (!mExcludedLayers[layerIndex])
 		{
-			mTiledMap->DrawLayer(layerIndex, window, viewRegion);
+			mTiledMap->DrawLayer(layerIndex, commands, viewRegion);
+		}
+	}
+
+	// Draws the layer, or when flattening the fixed run starting at it. Returns the
+	// last layer drawn, sprites at any depth up to it go above the whole run
+	size_t DrawLayers(size_t layerIndex, RenderCommandList& commands, const ViewRegion& viewRegion)
+	{
+		if (mRunEnds.empty() || !IsLayerCacheable(layerIndex))
+		{
+			DrawLayer(layerIndex, commands, viewRegion);
+			return layerIndex;
+		}
+
+		const size_t lastLayer = mRunEnds[layerIndex];
+		mChunkCache.DrawRun(layerIndex, lastLayer, commands, viewRegion);
+		return lastLayer;
+	}
+
+	// Splits the static layers into runs ending at every boundary depth and builds
+	// their chunks. Called once while loading, the runs then never change
+	template<typename IsRunBoundary>
+	void BuildRuns(IsRunBoundary isRunBoundary)
+	{
+		mChunkCache.Clear();
+		mRunEnds.clear();
+		if (!mFlattenStaticLayers)
+		{
+			return;
+		}
+
+		mRunEnds.assign(mTiledMap->LayerCount(), 0);
+		for (size_t layerIndex = 0; layerIndex < mTiledMap->LayerCount(); layerIndex++)
+		{
+			if (IsLayerCacheable(layerIndex))
+			{
+				const size_t lastLayer = FindRunEnd(layerIndex, isRunBoundary);
+				mRunEnds[layerIndex] = lastLayer;
+				mChunkCache.BuildRun(layerIndex, lastLayer);
+				layerIndex = lastLayer;
+			}
 		}
 	}
 
 private:
+	template<typename IsRunBoundary>
+	size_t FindRunEnd(size_t layerIndex, IsRunBoundary isRunBoundary)
+	{
+		size_t lastLayer = layerIndex;
+		while (!isRunBoundary(lastLayer)
+			&& lastLayer + 1 < mTiledMap->LayerCount()
+			&& IsLayerCacheable(lastLayer + 1)
+			&& !mTiledMap->HasAnimatedTiles(lastLayer + 1))
+		{
+			lastLayer++;
+		}
+		return lastLayer;
+	}
+
+	bool IsLayerCacheable(size_t layerIndex)
+	{
+		return !mExcludedLayers[layerIndex] && mChunkCache.IsLayerCacheable(layerIndex);
+	}
+
 	TiledMap* mTiledMap;
 	std::vector<bool> mExcludedLayers;
+	TiledMapChunkCache mChunkCache;
+	bool mFlattenStaticLayers;
+	std::vector<size_t> mRunEnds; // by first layer, empty until BuildRuns
 };
 
 
 //------------------------------------------------------------------------------
-class Level : public Scene, public ITreeObserver, public IPlayerObserver
+// Snapshot layout: header, RNG, level flags, soil block, tree block, player, villagers
+constexpr uint32_t SNAPSHOT_MAGIC = 0x53535650; // "PVSS"
+constexpr uint16_t SNAPSHOT_VERSION = 4;
+
+struct SnapshotHeader
+{
+	uint32_t mMagic;
+	uint16_t mVersion;
+	uint16_t mFlags;
+	uint32_t mPayloadSize;
+};
+
+//------------------------------------------------------------------------------
+struct LevelOptions
+{
+	// Skips everything that only serves rendering, including the map's tile
+	// animations, so a headless level never writes to shared assets
+	bool mIsHeadless{ false };
+	uint32_t mPathfindingWorkers{ PATHFINDING_WORKERS };
+	uint32_t mVillagerCount{ VILLAGER_COUNT };
+	std::string mAutosaveFile{ AUTOSAVE_FILE }; // empty disables autosave
+	std::string mMapId{ "main" };	// TiledMap asset, e.g. a generated stress map
+};
+
+//------------------------------------------------------------------------------
+struct LevelStats
+{
+	uint32_t mDaysCompleted;
+	uint32_t mTreesStanding;
+	uint32_t mSpriteCount;
+	std::map<std::string, int32_t> mInventory;
+};
+
+//------------------------------------------------------------------------------
+class Level : public Scene, public ITreeObserver, public IPlayerObserver, public IQualityListener
 {
 public:
+	explicit Level(LevelOptions options = LevelOptions())
+		: mOptions(std::move(options))
+	{ }
+
+	~Level()
+	{
+		if (mEventBus)
+		{
+			mEventBus->Unsubscribe(this);
+		}
+		if (!mOptions.mIsHeadless)
+		{
+			GetResourceLocator().GetQualityGovernor().RemoveListener(this);
+		}
+	}
+
 	void Create() override
 	{
 		mAllSprites = CreateGroup();
 		mTreeSprites = CreateGroup();
+
+		// Everything drawn is simulated, at a rate set by its distance from the camera
+		GetUpdateScheduler().Configure({ UPDATE_CELL_SIZE, UPDATE_NEAR_CELLS, UPDATE_FAR_CELLS, SelectForQuality(OFFSCREEN_UPDATE_INTERVAL, QualityLevel::High) });
+		ScheduleUpdates(mAllSprites);
 		mCollisionSprites = CreateGroup();
 		mInteractionSprites = CreateGroup();
 
+		mEventBus = &GetEventBus();
+		mEventBus->Subscribe<ItemCollectedEvent>(this, [this](const ItemCollectedEvent* events, size_t count) {
+			CollectItems(events, count);
+		});
+
 		AssetManager& assetManager = GetResourceLocator().GetAssetManager();
 
 		const ApplicationConfig& config = GetResourceLocator().GetApplicationConfig();
@@ -71,14 +213,24 @@ public:
 		mHUDView.setSize(windowSize);
 		mHUDView.setCenter(windowSize * 0.5f);
 
-		mTiledMap = &assetManager.GetAsset<TiledMap>("main");
-		mLayerRenderer = std::make_unique<SceneLayerRenderer>(mTiledMap);
+		mTiledMap = assetManager.AcquireAsset<TiledMap>(mOptions.mMapId);
+		if (!mOptions.mIsHeadless)
+		{
+			mLayerRenderer = std::make_unique<SceneLayerRenderer>(&mTiledMap.Get(), FLATTEN_STATIC_LAYERS);
+
+			// Headless levels share the governor across threads and never render, so stay at full rate
+			GetResourceLocator().GetQualityGovernor().AddListener(this);
+		}
 
-		mSoilLayer = std::make_unique<SoilLayer>(*mAllSprites, *this);
+		mSoilLayer = std::make_unique<SoilLayer>(*mAllSprites, *this, *mTiledMap);
 		
-		// Rain
-		mRain = std::make_unique<Rain>(*mAllSprites, *this);
-		mIsRaining = mIsRaining = IsRandomNumberLessThanOrEqualTo(0, 10, 3);
+		// Rain, the drops are cosmetic so headless levels only track the weather
+		if (!mOptions.mIsHeadless)
+		{
+			mRain = std::make_unique<Rain>(*mAllSprites, *this);
+		}
+		mRainChance = mTiledMap->GetIntProperty("rainChance", RAIN_CHANCE);
+		mIsRaining = IsRandomNumberLessThanOrEqualTo(0, 10, mRainChance);
 		mSoilLayer->SetIsRaining(mIsRaining);
 
 		// 5 - player (temporary code)
@@ -96,88 +248,79 @@ public:
 		// Fence
 		for (const std::string& layerName : { "Fence" })
 		{
-			mLayerRenderer->ExcludeLayerFromRendering(layerName);
-			for (auto& definition : mTiledMap->GetObjectDefinitions(layerName))
-			{
-				auto* sprite = CreateGameObject<TiledMapObjectSprite>(definition,
-					depthMap.at(layerName));
-				mAllSprites->Add(sprite);
-				mCollisionSprites->Add(sprite);
-			}
+			ExcludeLayerFromRendering(layerName);
+			SpawnGameObjects<TiledMapObjectSprite>(mTiledMap->GetObjectDefinitions(layerName, &GetFrameArena()),
+				{ mAllSprites, mCollisionSprites },
+				depthMap.at(layerName));
 		}
 
+		// Static and never collided with, so stored as entities rather than game objects
 		for (const std::string& layerName : { "HouseFloor", "HouseFurnitureBottom" })
 		{
-			mLayerRenderer->ExcludeLayerFromRendering(layerName);
-			for (auto& definition : mTiledMap->GetObjectDefinitions(layerName))
+			ExcludeLayerFromRendering(layerName);
+			for (auto& definition : mTiledMap->GetObjectDefinitions(layerName, &GetFrameArena()))
 			{
-				auto* sprite = CreateGameObject<TiledMapObjectSprite>(definition,
-					depthMap.at(layerName));
-				mAllSprites->Add(sprite);
+				CreateSpriteEntity(GetWorld(), definition, depthMap.at(layerName));
 			}
+			mEntityDepths.resize(std::max<size_t>(mEntityDepths.size(), depthMap.at(layerName) + 1), false);
+			mEntityDepths[depthMap.at(layerName)] = true;
 		}
 
 		for (const std::string& layerName : { "HouseWalls", "HouseFurnitureTop" })
 		{
-			mLayerRenderer->ExcludeLayerFromRendering(layerName);
-			for (auto& definition : mTiledMap->GetObjectDefinitions(layerName))
-			{
-				auto* sprite = CreateGameObject<TiledMapObjectSprite>(definition,
-					depthMap.at(layerName));
-				mAllSprites->Add(sprite);
-			}
+			ExcludeLayerFromRendering(layerName);
+			SpawnGameObjects<TiledMapObjectSprite>(mTiledMap->GetObjectDefinitions(layerName, &GetFrameArena()),
+				{ mAllSprites },
+				depthMap.at(layerName));
 		}
 
 		// Trees
 		for (const std::string& layerName : { "Trees" })
 		{
-			mLayerRenderer->ExcludeLayerFromRendering(layerName);
-			for (auto& definition : mTiledMap->GetObjectDefinitions(layerName))
+			ExcludeLayerFromRendering(layerName);
+			for (Tree* tree : SpawnGameObjects<Tree>(mTiledMap->GetObjectDefinitions(layerName, &GetFrameArena()),
+				{ mAllSprites, mCollisionSprites, mTreeSprites },
+				*mAllSprites,
+				depthMap.at(layerName)))
 			{
-				Tree* object = CreateGameObject<Tree>(std::move(definition),
-					*mAllSprites,
-					depthMap.at(layerName));
-				mAllSprites->Add(object);
-				mCollisionSprites->Add(object);
-				mTreeSprites->Add(object);
-
-				object->Subscribe(this);
+				tree->Subscribe(this);
 			}
 		}
 
 		// Wild flowers
 		for (const std::string& layerName : { "Decoration" })
 		{
-			mLayerRenderer->ExcludeLayerFromRendering(layerName);
-			for (auto& definition : mTiledMap->GetObjectDefinitions(layerName))
-			{
-				WildFlower* object = CreateGameObject<WildFlower>(std::move(definition),
-					depthMap.at(layerName));
-				mAllSprites->Add(object);
-				mCollisionSprites->Add(object);
-			}
+			ExcludeLayerFromRendering(layerName);
+			SpawnGameObjects<WildFlower>(mTiledMap->GetObjectDefinitions(layerName, &GetFrameArena()),
+				{ mAllSprites, mCollisionSprites },
+				depthMap.at(layerName));
 		}
 
-		// Collion tiles
+		// Collision tiles, baked into merged rectangles with the inset a tile sprite's
+		// hitbox used to have
+		const sf::Vector2f tileSize = mTiledMap->GetTileSize();
+		mStaticCollision = std::make_unique<StaticCollisionMap>(sf::Vector2u(mTiledMap->GetTileCount2Dim()),
+			tileSize, sf::Vector2f(tileSize.x * 0.1f, tileSize.y * 0.375f));
 		for (const std::string& layerName : { "Collision" })
 		{
-			mLayerRenderer->ExcludeLayerFromRendering(layerName);
-			for (auto& definition : mTiledMap->GetObjectDefinitions(layerName))
+			ExcludeLayerFromRendering(layerName);
+			for (const sf::Vector2i& cell : mTiledMap->GetOccupiedCells(layerName))
 			{
-				auto* sprite = CreateGameObject<TiledMapObjectSprite>(definition,
-					mTiledMap->GetLayerIndex(layerName).value());
-				mCollisionSprites->Add(sprite);
+				mStaticCollision->SetSolid(cell);
 			}
 		}
+		mStaticCollision->Bake();
 
 		// Player
-		for (auto& definition : mTiledMap->GetObjectDefinitions("Player"))
+		ExcludeLayerFromRendering("Player");
+		for (auto& definition : mTiledMap->GetObjectDefinitions("Player", &GetFrameArena()))
 		{
-			mLayerRenderer->ExcludeLayerFromRendering("Player");
 			if (definition.GetName() == "Start")
 			{
 				mPlayer = CreateGameObject<Player>(assetManager,
+					GetInput(),
 					definition.GetPosition(),
+					*mStaticCollision,
 					*mCollisionSprites,
 					*mTreeSprites,
 					*mInteractionSprites,
@@ -193,10 +336,44 @@ public:
 			}
 		}
 
-		mOverlay = std::make_unique<Overlay>(assetManager, *mPlayer);
+		if (!mOptions.mIsHeadless)
+		{
+			mOverlay = std::make_unique<Overlay>(assetManager, *mPlayer, config.GetWindowSize());
+			mAudio = std::make_unique<GameAudio>(GetResourceLocator().GetAudio(), assetManager);
+			mAudio->SetWeather(mIsRaining);
+			mSky = std::make_unique<Sky>(mTiledMap->GetMapSize(), FindLamps(), mPlayer->GetCenter());
+		}
+
+		// Navigation, trees keep it current through HitboxChanged
+		mNavGrid = std::make_unique<NavGrid>(sf::Vector2u(mTiledMap->GetTileCount2Dim()), mTiledMap->GetTileSize());
+		for (const sf::FloatRect& rect : mStaticCollision->GetRects())
+		{
+			mNavGrid->AddBlocker(rect);
+		}
+
+		// Group additions are deferred to PostUpdate, flush them so the dynamic colliders are seen
+		mCollisionSprites->Update();
+		for (GameObject* gameObject : *mCollisionSprites)
+		{
+			mNavGrid->AddBlocker(static_cast<Sprite*>(gameObject)->GetHitbox());
+		}
+		mPathfinding = std::make_unique<PathfindingService>(*mNavGrid, mOptions.mPathfindingWorkers);
+
+		// Villagers, drawn alongside the player
+		mVillagerAnimation = assetManager.AcquireAsset<Animation>("character");
+		mVillagerFrames = std::make_unique<AnimationFrameTable>(mVillagerAnimation.Get());
+		SpawnVillagers();
 
 		// Subscribe observers
 		mPlayer->Subscribe(this);
+
+		// Static layer chunks are built while loading rather than as they scroll into view
+		if (mLayerRenderer)
+		{
+			mAllSprites->Update();
+			BucketSpritesByDepth();
+			mLayerRenderer->BuildRuns([this](size_t depth) { return IsRunBoundary(depth); });
+		}
 	}
 
 	void Reset()
@@ -209,41 +386,251 @@ public:
 			mSoilLayer->RemoveAllWaterSoilTiles();
 		}
 
-		mIsRaining = IsRandomNumberLessThanOrEqualTo(0, 10, 3);
+		mIsRaining = IsRandomNumberLessThanOrEqualTo(0, 10, mRainChance);
 		mSoilLayer->SetIsRaining(mIsRaining);
 		if (mIsRaining)
 		{
 			mSoilLayer->WaterAll();
 		}
+		if (mAudio)
+		{
+			mAudio->SetWeather(mIsRaining);
+		}
+
+		mDaysCompleted++;
+		mClock.StartDay();
+		if (!mOptions.mAutosaveFile.empty())
+		{
+			Autosave(mOptions.mAutosaveFile);
+		}
+	}
+
+	LevelStats GetStats() const
+	{
+		uint32_t treesStanding = 0;
+		for (GameObject* gameObject : *mTreeSprites)
+		{
+			treesStanding += static_cast<Tree*>(gameObject)->GetState().mAlive;
+		}
+		return { mDaysCompleted, treesStanding, static_cast<uint32_t>(mAllSprites->GetSize()), mPlayer->GetInventory() };
+	}
+
+	// Y-sort order used for drawing, sprites lower on screen draw on top
+	static bool SpriteCompareFunc(const GameObject* object1, const GameObject* object2)
+	{
+		float y1 = static_cast<const Sprite*>(object1)->GetCenter().y;
+		float y2 = static_cast<const Sprite*>(object2)->GetCenter().y;
+
+		return y1 < y2;
+	}
+
+	// Captures the simulation state into outBuffer, reusing its capacity
+	void SaveSnapshot(std::vector<uint8_t>& outBuffer)
+	{
+		outBuffer.clear();
+		BinaryWriter writer(outBuffer);
+
+		writer.Write(SnapshotHeader{ SNAPSHOT_MAGIC, SNAPSHOT_VERSION, 0, 0 });
+		size_t payloadStart = writer.GetSize();
+
+		writer.Write(GetRandomState());
+		writer.Write(static_cast<uint8_t>(mIsRaining));
+		writer.Write(mClock.GetElapsedSeconds());
+
+		mSoilLayer->SaveState(writer);
+
+		mTreeStates.clear();
+		for (GameObject* gameObject : *mTreeSprites)
+		{
+			mTreeStates.push_back(static_cast<Tree*>(gameObject)->GetState());
+		}
+		writer.WriteArray(mTreeStates.data(), mTreeStates.size());
+
+		mPlayer->SaveState(writer);
+		mVillagers->SaveState(writer);
+
+		writer.Patch(offsetof(SnapshotHeader, mPayloadSize), static_cast<uint32_t>(writer.GetSize() - payloadStart));
+	}
+
+	void RestoreSnapshot(const std::vector<uint8_t>& buffer)
+	{
+		BinaryReader reader(buffer);
+
+		SnapshotHeader header = reader.Read<SnapshotHeader>();
+		if (header.mMagic != SNAPSHOT_MAGIC || header.mVersion != SNAPSHOT_VERSION)
+		{
+			throw std::runtime_error("Unsupported level snapshot");
+		}
+		if (header.mPayloadSize != reader.GetRemaining())
+		{
+			throw std::runtime_error("Truncated level snapshot");
+		}
+
+		RandomState randomState = reader.Read<RandomState>();
+		mIsRaining = reader.Read<uint8_t>() != 0;
+		mSoilLayer->SetIsRaining(mIsRaining);
+		mClock.SetElapsedSeconds(reader.Read<float>());
+		if (mAudio)
+		{
+			mAudio->SetWeather(mIsRaining);
+		}
+
+		mSoilLayer->RestoreState(reader);
+
+		reader.ReadArray(mTreeStates);
+		if (mTreeStates.size() != mTreeSprites->GetSize())
+		{
+			throw std::runtime_error("Level snapshot does not match the tree layout");
+		}
+		size_t treeIndex = 0;
+		for (GameObject* gameObject : *mTreeSprites)
+		{
+			static_cast<Tree*>(gameObject)->SetState(mTreeStates[treeIndex++]);
+		}
+
+		mPlayer->RestoreState(reader);
+		mVillagers->RestoreState(reader);
+
+		// Last, so random draws made while rebuilding sprites do not leak into the restored run
+		SetRandomState(randomState);
+	}
+
+	// Writes a snapshot on a worker thread, skipped while the previous write is in flight
+	bool Autosave(const std::string& filePath)
+	{
+		if (mAutosaveTask.valid() && mAutosaveTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			return false;
+		}
+
+		std::vector<uint8_t> buffer;
+		SaveSnapshot(buffer);
+		mAutosaveTask = std::async(std::launch::async, [filePath, buffer = std::move(buffer)]() {
+			WriteBinaryFile(filePath, buffer);
+		});
+		return true;
+	}
+
+	void LoadSnapshotFromFile(const std::string& filePath)
+	{
+		RestoreSnapshot(ReadBinaryFile(filePath));
+	}
+
+	// A frame's pickups in one pass, so the HUD redraws and the sound plays once
+	void CollectItems(const ItemCollectedEvent* events, size_t count)
+	{
+		std::array<int32_t, INVENTORY_ITEM_NAMES.size()> totals{ };
+		for (size_t index = 0; index < count; index++)
+		{
+			totals[static_cast<size_t>(events[index].mItem)] += events[index].mCount;
+		}
+
+		for (size_t item = 0; item < totals.size(); item++)
+		{
+			if (totals[item] > 0)
+			{
+				mPlayer->AddItemToInventory(INVENTORY_ITEM_NAMES[item], totals[item]);
+			}
+		}
+		mPlayer->NotifyInventoryChanged();
+
+		if (mAudio)
+		{
+			mAudio->PlaySuccess();
+		}
 	}
 
 	// ITreeObserver interface
-	virtual void AddItem(const std::string& item) override
+	virtual void HitboxChanged(const sf::FloatRect& oldHitbox, const sf::FloatRect& newHitbox) override
 	{
-		mPlayer->AddItemToInventory(item);
+		if (mNavGrid)
+		{
+			mNavGrid->MoveBlocker(oldHitbox, newHitbox);
+		}
 	}
 
 	// IPlayerObserver interface
+	virtual void ToolUsed(const std::string& tool) override
+	{
+		if (mAudio)
+		{
+			mAudio->PlayTool(tool);
+		}
+	}
+
+	virtual void SeedUsed(const std::string& seed) override
+	{
+		if (mAudio)
+		{
+			mAudio->PlayPlant();
+		}
+	}
+
 	virtual void WentToSleep() override
 	{
 		PushLayer(std::make_unique<Transition>(*mPlayer, std::bind(&Level::Reset, this)));
 	}
 
-	void Update(const sf::Time& timestamp) override
+	// IQualityListener interface
+	virtual void OnQualityChanged(QualityLevel level) override
 	{
-		mTiledMap->Update(timestamp);
+		mTileAnimationInterval = SelectForQuality(TILE_ANIMATION_INTERVAL, level);
+		GetUpdateScheduler().SetFarInterval(SelectForQuality(OFFSCREEN_UPDATE_INTERVAL, level));
+		mIsDebugDrawEnabled = SelectForQuality(DEBUG_DRAWS, level);
+	}
 
-		for (GameObject* gameObject : *mAllSprites)
+	void Update(const sf::Time& timestamp) override
+	{
+		mTick++;
+		if (!mOptions.mIsHeadless)
 		{
-			gameObject->Update(timestamp);
+			// Skipped ticks are accumulated so animations keep their speed
+			mTileAnimationTime += timestamp;
+			if (mTick % mTileAnimationInterval == 0)
+			{
+				mTiledMap->Update(mTileAnimationTime);
+				mTileAnimationTime = sf::Time::Zero;
+			}
 		}
 
-		if (mIsRaining)
+		GetUpdateScheduler().SetFocus(mWorldView.getCenter());
+		UpdateScheduledObjects(timestamp);
+
+		// Fire timers after objects so a timer started this tick sees the full step
+		GetTimerWheel().Advance(timestamp);
+		mPathfinding->Poll();
+		mVillagers->Update(timestamp);
+
+		if (mIsRaining && mRain)
 		{
 			mRain->Update(GetViewRegion());
 		}
 
 		mWorldView.setCenter(mPlayer->GetCenter());
+		mClock.Advance(timestamp);
+		if (mSky)
+		{
+			mSky->Update(mClock.GetMinuteOfDay(), mPlayer->GetCenter());
+		}
+		if (mOverlay)
+		{
+			UpdateOverlay();
+		}
+	}
+
+	// Unchanged values are a compare, the HUD texture is redrawn only when text changes
+	void UpdateOverlay()
+	{
+		mOverlay->SetTimeOfDay(mClock.GetMinuteOfDay());
+		if (HUD_DEBUG_STATS && mTick % HUD_STATS_INTERVAL == 0)
+		{
+			const HudStats stats{
+				GetResourceLocator().GetQualityGovernor().GetAverageFrameTime(),
+				static_cast<uint32_t>(mAllSprites->GetSize()),
+				GetResourceLocator().GetAudio().GetStats().mActiveVoices
+			};
+			mOverlay->SetDebugStats(stats);
+		}
 	}
 
 	sf::FloatRect GetViewRegion(const sf::View& view)
@@ -257,42 +644,151 @@ public:
 		return sf::FloatRect(topLeft, bottomRight - topLeft);
 	}
 
-	virtual void Draw(sf::RenderWindow& window)
+	virtual void Draw(RenderCommandList& commands)
 	{
-		window.setView(mWorldView);
+		commands.setView(mWorldView);
 
-		mAllSprites->Sort(SpriteCompareFunc);
+		// Re-sort only when something moved or the sprite set changed
+		TakeChangedSprites(mChangedSprites);
+		if (!mChangedSprites.empty() || mAllSprites->GetRevision() != mSortedRevision)
+		{
+			mAllSprites->Sort(SpriteCompareFunc);
+			BucketSpritesByDepth();
+			mSortedRevision = mAllSprites->GetRevision();
+		}
+		const sf::FloatRect worldRegion = GetViewRegion(mWorldView);
+		mSpriteEntityRenderer.Prepare(GetWorld(), worldRegion);
 
 		const ViewRegion viewRegion = GetViewRegion();
-		for (size_t layerIndex = 0; layerIndex < mTiledMap->LayerCount(); layerIndex++)
+		for (size_t layerIndex = 0; layerIndex < mTiledMap->LayerCount();)
 		{
-			mLayerRenderer->DrawLayer(layerIndex, window, viewRegion);
-
-			for (GameObject* gameObject : *mAllSprites)
+			const size_t lastLayer = mLayerRenderer->DrawLayers(layerIndex, commands, viewRegion);
+			for (; layerIndex <= lastLayer; layerIndex++)
 			{
-				if (gameObject->GetDepth() == layerIndex)
+				mSpriteEntityRenderer.Draw(layerIndex, commands);
+
+				DrawVisibleSprites(layerIndex, commands, worldRegion);
+
+				if (layerIndex == mPlayer->GetDepth())
 				{
-					window.draw(*gameObject);
+					mVillagers->Draw(commands, worldRegion);
 				}
 			}
 		}
-		DebugDrawHitboxes(window);
-		DrawPlayerTargetPosition(window);
+		if (mSky)
+		{
+			mSky->Draw(commands);
+		}
+		if (mIsDebugDrawEnabled)
+		{
+			DebugDrawHitboxes(commands);
+			DrawPlayerTargetPosition(commands);
+		}
+
+		commands.setView(mHUDView);
+		mOverlay->Draw(commands);
+	}
+
+	// Flattened runs end at depths holding sprites once loaded and at the depths
+	// gameplay fills later, so the runs stay fixed while playing. Independent of
+	// the view, so scrolling never changes them either
+	bool IsRunBoundary(size_t depth) const
+	{
+		for (const char* layerName : { "soil", "soil water", "rain floor", "ground plant", "main", "fruit", "rain drops" })
+		{
+			if (LAYERS.at(layerName) == depth)
+			{
+				return true;
+			}
+		}
+		return !mSpritesByDepth[depth].empty() || (depth < mEntityDepths.size() && mEntityDepths[depth]);
+	}
 
-		window.setView(mHUDView);
-		mOverlay->Draw(window);
+	void BucketSpritesByDepth()
+	{
+		// Single pass over the sorted sprites, preserving draw order within a depth.
+		// Bounds only change through InvalidateTransform, which also triggers this
+		// rebuild, so the per depth bounds stay exact between rebuilds.
+		mSpritesByDepth.resize(mTiledMap->LayerCount());
+		mSpriteBoundsByDepth.resize(mTiledMap->LayerCount());
+		for (size_t depth = 0; depth < mSpritesByDepth.size(); depth++)
+		{
+			mSpritesByDepth[depth].clear();
+			mSpriteBoundsByDepth[depth].Clear();
+		}
+
+		for (GameObject* gameObject : *mAllSprites)
+		{
+			if (gameObject->GetDepth() < mSpritesByDepth.size())
+			{
+				mSpritesByDepth[gameObject->GetDepth()].push_back(gameObject);
+				mSpriteBoundsByDepth[gameObject->GetDepth()].Add(static_cast<Sprite*>(gameObject)->GetGlobalBounds());
+			}
+		}
 	}
 
-	void DebugDrawHitboxes(sf::RenderWindow& window)
+	// Culls the depth's sprites against the view in one batched pass
+	void DrawVisibleSprites(size_t layerIndex, RenderCommandList& commands, const sf::FloatRect& worldRegion)
+	{
+		const std::vector<GameObject*>& sprites = mSpritesByDepth[layerIndex];
+		mVisibleSprites.resize(sprites.size());
+		if (mSpriteBoundsByDepth[layerIndex].ComputeOverlapMask(worldRegion, mVisibleSprites.data()) == 0)
+		{
+			return;
+		}
+
+		for (size_t index = 0; index < sprites.size(); index++)
+		{
+			if (mVisibleSprites[index])
+			{
+				static_cast<Sprite*>(sprites[index])->Draw(commands);
+			}
+		}
+	}
+
+	PathfindingService& GetPathfinding() { return *mPathfinding; }
+
+	// The house interior and the trader's stall, lit at night
+	std::vector<PointLight> FindLamps()
+	{
+		std::vector<PointLight> lamps;
+		const std::vector<sf::Vector2i> floorCells = mTiledMap->GetOccupiedCells("HouseFloor");
+		if (!floorCells.empty())
+		{
+			sf::Vector2i first = floorCells.front();
+			sf::Vector2i last = first;
+			for (const sf::Vector2i& cell : floorCells)
+			{
+				first = { std::min(first.x, cell.x), std::min(first.y, cell.y) };
+				last = { std::max(last.x, cell.x), std::max(last.y, cell.y) };
+			}
+
+			const sf::Vector2f tileSize = mTiledMap->GetTileSize();
+			const sf::Vector2f topLeft(first.x * tileSize.x, first.y * tileSize.y);
+			const sf::Vector2f size((last.x - first.x + 1) * tileSize.x, (last.y - first.y + 1) * tileSize.y);
+			lamps.push_back({ topLeft + size * 0.5f, std::max(size.x, size.y) * 0.75f, Sky::LAMP_COLOR });
+		}
+
+		for (auto& definition : mTiledMap->GetObjectDefinitions("Player", &GetFrameArena()))
+		{
+			if (definition.GetName() == "Trader")
+			{
+				lamps.push_back({ definition.GetPosition() + definition.GetSize() * 0.5f, LAMP_RADIUS, Sky::LAMP_COLOR });
+			}
+		}
+		return lamps;
+	}
+
+	void DebugDrawHitboxes(RenderCommandList& commands)
 	{
 		for (GameObject* gameObject : *mTreeSprites)
 		{
-			//DrawRect(window, static_cast<Sprite*>(gameObject)->GetHitbox(), sf::Color::Red);
-			DrawRect(window, static_cast<Sprite*>(gameObject)->GetGlobalBounds(), sf::Color::Blue);
+			//DrawRect(commands, static_cast<Sprite*>(gameObject)->GetHitbox(), sf::Color::Red);
+			DrawRect(commands, static_cast<Sprite*>(gameObject)->GetGlobalBounds(), sf::Color::Blue);
 		}
 	}
 
-	void DrawPlayerTargetPosition(sf::RenderWindow& window)
+	void DrawPlayerTargetPosition(RenderCommandList& commands)
 	{
 		float radius = 5.0f;
 		sf::Vector2f offset(-radius, -radius);
@@ -301,22 +797,63 @@ public:
 		point.setPosition(mPlayer->GetTargetPosition() + offset);
 		point.setFillColor(sf::Color::Red);
 
-		window.draw(point);
+		commands.draw(point);
 	}
 
 	virtual void OnWindowResize(const sf::Vector2u& size)
 	{
 		mWorldView.setSize(sf::Vector2f(size));
 		mHUDView.setSize(sf::Vector2f(size));
+		mHUDView.setCenter(sf::Vector2f(size) * 0.5f);
+		if (mOverlay)
+		{
+			mOverlay->Resize(size);
+		}
 	}
 
 private:
-	static bool SpriteCompareFunc(const GameObject* object1, const GameObject* object2)
+	void SpawnVillagers()
 	{
-		float y1 = static_cast<const Sprite*>(object1)->GetCenter().y;
-		float y2 = static_cast<const Sprite*>(object2)->GetCenter().y;
+		auto sequence = [this](const std::string& id) { return mVillagerFrames->GetSequenceIndex(id); };
+		const CrowdAnimationSet animationSet{
+			{ sequence("up"), sequence("down"), sequence("left"), sequence("right") },
+			{ sequence("up_idle"), sequence("down_idle"), sequence("left_idle"), sequence("right_idle") }
+		};
 
-		return y1 < y2;
+		// Wandering draws from its own stream, seeded from the level's so replays repeat it
+		CrowdSettings settings;
+		settings.mSeed = static_cast<uint32_t>(RandomInteger(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+
+		mVillagers = std::make_unique<Crowd>(*mVillagerFrames, animationSet,
+			sf::FloatRect(sf::Vector2f(), mTiledMap->GetMapSize()), settings);
+		mVillagers->SetNavigation(mNavGrid.get(), mPathfinding.get());
+		mVillagers->Reserve(mOptions.mVillagerCount);
+
+		// Tint villagers so they can't be mistaken for the player
+		static const std::array<sf::Color, 4> tints = {
+			sf::Color(255, 220, 200), sf::Color(200, 220, 255), sf::Color(220, 255, 200), sf::Color(255, 240, 180)
+		};
+
+		const sf::Vector2u cellCount = mNavGrid->GetCellCount();
+		const uint32_t villagerCount = mOptions.mVillagerCount;
+		for (uint32_t villager = 0, attempts = 0; villager < villagerCount && attempts < villagerCount * 16; attempts++)
+		{
+			sf::Vector2i cell(RandomInteger(0, static_cast<int32_t>(cellCount.x) - 1),
+						  RandomInteger(0, static_cast<int32_t>(cellCount.y) - 1));
+			if (mNavGrid->IsWalkable(cell))
+			{
+				mVillagers->AddAgent(mNavGrid->CellToWorld(cell), 120.0f, tints[villager % tints.size()]);
+				villager++;
+			}
+		}
+	}
+
+	void ExcludeLayerFromRendering(const std::string& layerName)
+	{
+		if (mLayerRenderer)
+		{
+			mLayerRenderer->ExcludeLayerFromRendering(layerName);
+		}
 	}
 
 	ViewRegion GetViewRegion()
@@ -328,21 +865,54 @@ private:
 		return { mTiledMap->GetTileSize(), mTiledMap->GetMapSize(), { position, size } };
 	}
 
+	LevelOptions mOptions;
+	uint32_t mDaysCompleted{ 0 };
+
+	// Driven by the quality governor
+	uint32_t mTick{ 0 };
+	GameClock mClock;
+	uint32_t mTileAnimationInterval{ 1 };
+	bool mIsDebugDrawEnabled{ true };
+	sf::Time mTileAnimationTime;
+
 	Player* mPlayer;
 	Generic* mGround;
 	std::unique_ptr<SoilLayer> mSoilLayer;
 	std::unique_ptr<Rain> mRain;
+	std::unique_ptr<Sky> mSky; // windowed levels only
 	bool mIsRaining;
+	int32_t mRainChance{ RAIN_CHANCE };
 
+	EventBus* mEventBus{ nullptr }; // set by Create, the layer stack owns it
 	Group* mAllSprites{ nullptr };
 	Group* mTreeSprites{ nullptr };
 	Group* mCollisionSprites{ nullptr };
 	Group* mInteractionSprites{ nullptr };
 
 	std::unique_ptr<Overlay> mOverlay;
+	std::unique_ptr<GameAudio> mAudio; // windowed levels only
 	sf::View mWorldView;
 	sf::View mHUDView;
 
-	TiledMap* mTiledMap;
+	AssetHandle<TiledMap> mTiledMap;
 	std::unique_ptr<SceneLayerRenderer> mLayerRenderer;
+	std::vector<std::vector<GameObject*>> mSpritesByDepth;
+	std::vector<RectBatch> mSpriteBoundsByDepth;
+	std::vector<uint8_t> mVisibleSprites;
+	std::vector<Sprite*> mChangedSprites;
+	uint32_t mSortedRevision{ UINT32_MAX };
+	SpriteEntityRenderer mSpriteEntityRenderer;
+	std::vector<bool> mEntityDepths; // depths holding static sprite entities
+
+	std::unique_ptr<StaticCollisionMap> mStaticCollision;
+	std::unique_ptr<NavGrid> mNavGrid;
+	std::unique_ptr<PathfindingService> mPathfinding;
+
+	// Declared after mPathfinding so pending path requests are cancelled first
+	AssetHandle<Animation> mVillagerAnimation;
+	std::unique_ptr<AnimationFrameTable> mVillagerFrames;
+	std::unique_ptr<Crowd> mVillagers;
+
+	std::vector<TreeState> mTreeStates;
+	std::future<void> mAutosaveTask;
 };
\ No newline at end of file
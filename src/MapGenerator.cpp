@@ -0,0 +1,535 @@
+#include "MapGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace
+{
+	namespace fs = std::filesystem;
+
+	// Gids as assigned by the tileset order below, the same as data/map.json
+	constexpr uint32_t GRASS_GID = 43;
+	constexpr uint32_t HILL_GID = 95;
+	constexpr uint32_t PLANT_DECORATION_GID = 133;
+	constexpr uint32_t PLANT_DECORATION_COUNT = 10;
+	constexpr uint32_t FARMABLE_GID = 169;
+	constexpr uint32_t COLLISION_GID = 170;
+	constexpr uint32_t WATER_ANIMATION_GID = 261;
+
+	constexpr float DETAIL_DENSITY = 0.06f;
+	constexpr uint32_t START_CLEARANCE = 2; // tiles kept free around the player start
+
+	struct TilesetReference
+	{
+		uint32_t mFirstGid;
+		const char* mFileName;
+	};
+
+	constexpr TilesetReference TILESETS[] = {
+		{ 1, "Grass.json" },
+		{ 81, "Hills.json" },
+		{ 117, "Fences.json" },
+		{ 133, "Plant Decoration.json" },
+		{ 143, "Objects.json" },
+		{ 153, "Paths.json" },
+		{ 169, "interaction.json" },
+		{ 171, "Water.json" },
+		{ 172, "House.json" },
+		{ 207, "House Decoration.json" }
+	};
+
+	struct ObjectTile
+	{
+		uint32_t mGid;
+		uint32_t mWidth;
+		uint32_t mHeight;
+		const char* mName; // Tree looks up its apples and stump by name
+		const char* mType;
+	};
+
+	constexpr ObjectTile TREES[] = {
+		{ 148, 96, 124, "Large", "" },
+		{ 149, 56, 116, "Small", "" }
+	};
+
+	constexpr ObjectTile FLOWERS[] = {
+		{ 143, 64, 60, "", "decor" },
+		{ 147, 56, 112, "", "decor" },
+		{ 150, 44, 48, "", "decor" },
+		{ 151, 40, 44, "", "decor" },
+		{ 152, 52, 52, "", "decor" }
+	};
+
+	enum class CellKind : uint8_t
+	{
+		Free,
+		Reserved,
+		Water,
+		Blocked,
+		Farmable,
+		Occupied,
+		Count
+	};
+
+	struct PlacedObject
+	{
+		const ObjectTile* mTile;
+		uint32_t mCellX;
+		uint32_t mCellY;
+	};
+
+	//--------------------------------------------------------------------------
+	// std distributions differ between standard libraries, the engine is fixed
+	class MapRandom
+	{
+	public:
+		explicit MapRandom(uint32_t seed)
+			: mEngine(seed)
+		{ }
+
+		bool Chance(float probability)
+		{
+			return static_cast<float>(mEngine() / 4294967296.0) < probability;
+		}
+
+		uint32_t Range(uint32_t min, uint32_t max) // inclusive
+		{
+			return min + mEngine() % (max - min + 1);
+		}
+
+	private:
+		std::mt19937 mEngine;
+	};
+
+	//--------------------------------------------------------------------------
+	class MapLayout
+	{
+	public:
+		MapLayout(const MapGeneratorConfig& config)
+			: mConfig(config)
+			, mRandom(config.mSeed)
+			, mCells(config.mWidth * config.mHeight, CellKind::Free)
+			, mKindCounts{ static_cast<uint32_t>(mCells.size()) }
+			, mStartX(config.mWidth / 2)
+			, mStartY(config.mHeight / 2)
+		{ }
+
+		void Generate()
+		{
+			const uint32_t tileCount = mConfig.mWidth * mConfig.mHeight;
+
+			// Border keeps the player on the map
+			for (uint32_t y = 0; y < mConfig.mHeight; y++)
+			{
+				for (uint32_t x = 0; x < mConfig.mWidth; x++)
+				{
+					if (x == 0 || y == 0 || x + 1 == mConfig.mWidth || y + 1 == mConfig.mHeight)
+					{
+						Set(x, y, CellKind::Blocked);
+					}
+				}
+			}
+			FillRect(mStartX - START_CLEARANCE, mStartY - START_CLEARANCE,
+					 START_CLEARANCE * 2 + 1, START_CLEARANCE * 2 + 1, CellKind::Reserved);
+
+			// The first field sits next to the start so the farm is reachable
+			const uint32_t farmableTarget = static_cast<uint32_t>(tileCount * mConfig.mFarmableFraction);
+			if (farmableTarget > 0)
+			{
+				FillRect(mStartX - 3, mStartY + START_CLEARANCE + 1, 7, 4, CellKind::Farmable);
+			}
+			PlaceClusters(farmableTarget, CellKind::Farmable, [this](uint32_t x, uint32_t y) {
+				FillRect(x, y, mRandom.Range(3, 8), mRandom.Range(3, 6), CellKind::Farmable);
+			});
+
+			PlaceClusters(static_cast<uint32_t>(tileCount * mConfig.mWaterFraction), CellKind::Water, [this](uint32_t x, uint32_t y) {
+				FillCircle(x, y, mRandom.Range(1, 4), CellKind::Water);
+			});
+
+			const uint32_t collisionTarget = Count(CellKind::Blocked) + static_cast<uint32_t>(tileCount * mConfig.mCollisionFraction);
+			PlaceClusters(collisionTarget, CellKind::Blocked, [this](uint32_t x, uint32_t y) {
+				FillRect(x, y, mRandom.Range(1, 2), mRandom.Range(1, 2), CellKind::Blocked);
+			});
+
+			PlaceObjects(mConfig.mTreeDensity, TREES, mTrees);
+			PlaceObjects(mConfig.mFlowerDensity, FLOWERS, mFlowers);
+
+			for (uint32_t layer = 0; layer < mConfig.mDetailLayerCount; layer++)
+			{
+				std::vector<uint32_t>& details = mDetailLayers.emplace_back(tileCount, 0);
+				for (uint32_t index = 0; index < tileCount; index++)
+				{
+					if (mCells[index] != CellKind::Water && mRandom.Chance(DETAIL_DENSITY))
+					{
+						details[index] = PLANT_DECORATION_GID + mRandom.Range(0, PLANT_DECORATION_COUNT - 1);
+					}
+				}
+			}
+		}
+
+		uint32_t Count(CellKind kind) const { return mKindCounts[static_cast<size_t>(kind)]; }
+
+		CellKind Get(uint32_t index) const { return mCells[index]; }
+
+		uint32_t GetStartX() const { return mStartX; }
+		uint32_t GetStartY() const { return mStartY; }
+		const std::vector<PlacedObject>& GetTrees() const { return mTrees; }
+		const std::vector<PlacedObject>& GetFlowers() const { return mFlowers; }
+		const std::vector<std::vector<uint32_t>>& GetDetailLayers() const { return mDetailLayers; }
+
+	private:
+		CellKind At(uint32_t x, uint32_t y) const { return mCells[y * mConfig.mWidth + x]; }
+
+		void Set(uint32_t x, uint32_t y, CellKind kind)
+		{
+			CellKind& cell = mCells[y * mConfig.mWidth + x];
+			mKindCounts[static_cast<size_t>(cell)]--;
+			mKindCounts[static_cast<size_t>(kind)]++;
+			cell = kind;
+		}
+
+		// Only claims free tiles, the border, start and earlier features win
+		void Claim(uint32_t x, uint32_t y, CellKind kind)
+		{
+			if (x < mConfig.mWidth && y < mConfig.mHeight && At(x, y) == CellKind::Free)
+			{
+				Set(x, y, kind);
+			}
+		}
+
+		void FillRect(uint32_t left, uint32_t top, uint32_t width, uint32_t height, CellKind kind)
+		{
+			for (uint32_t y = top; y < top + height; y++)
+			{
+				for (uint32_t x = left; x < left + width; x++)
+				{
+					Claim(x, y, kind);
+				}
+			}
+		}
+
+		void FillCircle(uint32_t centerX, uint32_t centerY, uint32_t radius, CellKind kind)
+		{
+			const int32_t r = static_cast<int32_t>(radius);
+			for (int32_t dy = -r; dy <= r; dy++)
+			{
+				for (int32_t dx = -r; dx <= r; dx++)
+				{
+					if (dx * dx + dy * dy <= r * r)
+					{
+						Claim(static_cast<uint32_t>(static_cast<int32_t>(centerX) + dx),
+							  static_cast<uint32_t>(static_cast<int32_t>(centerY) + dy), kind);
+					}
+				}
+			}
+		}
+
+		// Stamps clusters at random tiles until the kind covers target tiles, or
+		// gives up once the map is too crowded to get there
+		template<typename Stamp>
+		void PlaceClusters(uint32_t target, CellKind kind, Stamp stamp)
+		{
+			const uint32_t maxAttempts = 64 + static_cast<uint32_t>(mCells.size()) / 2;
+			for (uint32_t attempt = 0; attempt < maxAttempts && Count(kind) < target; attempt++)
+			{
+				stamp(mRandom.Range(1, mConfig.mWidth - 2), mRandom.Range(1, mConfig.mHeight - 2));
+			}
+		}
+
+		template<size_t N>
+		void PlaceObjects(float density, const ObjectTile (&tiles)[N], std::vector<PlacedObject>& outObjects)
+		{
+			for (uint32_t y = 0; y < mConfig.mHeight; y++)
+			{
+				for (uint32_t x = 0; x < mConfig.mWidth; x++)
+				{
+					if (At(x, y) == CellKind::Free && mRandom.Chance(density))
+					{
+						Set(x, y, CellKind::Occupied);
+						outObjects.push_back({ &tiles[mRandom.Range(0, N - 1)], x, y });
+					}
+				}
+			}
+		}
+
+		MapGeneratorConfig mConfig;
+		MapRandom mRandom;
+		std::vector<CellKind> mCells;
+		std::array<uint32_t, static_cast<size_t>(CellKind::Count)> mKindCounts;
+		uint32_t mStartX;
+		uint32_t mStartY;
+		std::vector<PlacedObject> mTrees;
+		std::vector<PlacedObject> mFlowers;
+		std::vector<std::vector<uint32_t>> mDetailLayers;
+	};
+
+	//--------------------------------------------------------------------------
+	class TiledJsonWriter
+	{
+	public:
+		TiledJsonWriter(std::ostream& stream, const MapGeneratorConfig& config)
+			: mStream(stream)
+			, mConfig(config)
+		{ }
+
+		template<typename GetGid>
+		void WriteTileLayer(const std::string& name, GetGid getGid)
+		{
+			BeginLayer();
+			mStream << "{\"data\":[";
+			const uint32_t tileCount = mConfig.mWidth * mConfig.mHeight;
+			for (uint32_t index = 0; index < tileCount; index++)
+			{
+				mStream << (index > 0 ? "," : "") << getGid(index);
+			}
+			mStream << "],\"height\":" << mConfig.mHeight << ",\"id\":" << mLayerCount
+					<< ",\"name\":\"" << name << "\",\"opacity\":1,\"type\":\"tilelayer\",\"visible\":true"
+					<< ",\"width\":" << mConfig.mWidth << ",\"x\":0,\"y\":0}";
+		}
+
+		void BeginObjectLayer(const std::string& name)
+		{
+			BeginLayer();
+			mLayerObjectCount = 0;
+			mStream << "{\"draworder\":\"topdown\",\"id\":" << mLayerCount << ",\"name\":\"" << name << "\",\"objects\":[";
+		}
+
+		void EndObjectLayer()
+		{
+			mStream << "],\"opacity\":1,\"type\":\"objectgroup\",\"visible\":true,\"x\":0,\"y\":0}";
+		}
+
+		// Tile objects are anchored at their bottom left corner, centred on the tile
+		void WriteTileObject(const PlacedObject& object)
+		{
+			const float x = object.mCellX * static_cast<float>(TILESIZE) + (static_cast<float>(TILESIZE) - object.mTile->mWidth) * 0.5f;
+			const float y = (object.mCellY + 1) * static_cast<float>(TILESIZE);
+			BeginObject(object.mTile->mName, object.mTile->mType, x, y, object.mTile->mWidth, object.mTile->mHeight);
+			mStream << ",\"gid\":" << object.mTile->mGid << "}";
+		}
+
+		void WriteRectObject(const char* name, float x, float y, float width, float height, bool isPoint = false)
+		{
+			BeginObject(name, "", x, y, width, height);
+			mStream << (isPoint ? ",\"point\":true}" : "}");
+		}
+
+		uint32_t GetLayerCount() const { return mLayerCount; }
+		uint32_t GetObjectCount() const { return mObjectCount; }
+
+	private:
+		void BeginLayer()
+		{
+			mStream << (mLayerCount > 0 ? "," : "");
+			mLayerCount++;
+		}
+
+		void BeginObject(const char* name, const char* type, float x, float y, float width, float height)
+		{
+			mStream << (mLayerObjectCount > 0 ? "," : "");
+			mLayerObjectCount++;
+			mObjectCount++;
+			mStream << "{\"height\":" << height << ",\"id\":" << mObjectCount << ",\"name\":\"" << name
+					<< "\",\"rotation\":0,\"type\":\"" << type << "\",\"visible\":true,\"width\":" << width
+					<< ",\"x\":" << x << ",\"y\":" << y;
+		}
+
+		std::ostream& mStream;
+		const MapGeneratorConfig& mConfig;
+		uint32_t mLayerCount{ 0 };
+		uint32_t mObjectCount{ 0 };
+		uint32_t mLayerObjectCount{ 0 };
+	};
+}
+
+//------------------------------------------------------------------------------
+const std::vector<MapScenario>& GetMapScenarios()
+{
+	static const std::vector<MapScenario> scenarios = []() {
+		std::vector<MapScenario> result;
+
+		MapGeneratorConfig baseline;
+		result.push_back({ "baseline", "Densities close to the hand made map", baseline });
+
+		MapGeneratorConfig hugeFarm;
+		hugeFarm.mFarmableFraction = 0.45f;
+		hugeFarm.mTreeDensity = 0.01f;
+		hugeFarm.mWaterFraction = 0.05f;
+		result.push_back({ "huge-farm", "Mostly farmable soil", hugeFarm });
+
+		MapGeneratorConfig denseForest;
+		denseForest.mTreeDensity = 0.3f;
+		denseForest.mFlowerDensity = 0.15f;
+		denseForest.mFarmableFraction = 0.05f;
+		denseForest.mDetailLayerCount = 4;
+		result.push_back({ "dense-forest", "Trees and flowers on most free tiles", denseForest });
+
+		MapGeneratorConfig rainHeavy;
+		rainHeavy.mRainChance = 10;
+		rainHeavy.mFarmableFraction = 0.3f;
+		rainHeavy.mWaterFraction = 0.2f;
+		result.push_back({ "rain-heavy", "Rains every day over large fields and water", rainHeavy });
+
+		return result;
+	}();
+	return scenarios;
+}
+
+//------------------------------------------------------------------------------
+const MapScenario* FindMapScenario(const std::string& name)
+{
+	for (const MapScenario& scenario : GetMapScenarios())
+	{
+		if (scenario.mName == name)
+		{
+			return &scenario;
+		}
+	}
+	return nullptr;
+}
+
+//------------------------------------------------------------------------------
+MapGeneratorConfig ScaleMapConfig(const MapGeneratorConfig& config, uint32_t areaScale)
+{
+	const float sideScale = std::sqrt(static_cast<float>(std::max<uint32_t>(areaScale, 1)));
+	MapGeneratorConfig scaled = config;
+	scaled.mWidth = static_cast<uint32_t>(std::lround(config.mWidth * sideScale));
+	scaled.mHeight = static_cast<uint32_t>(std::lround(config.mHeight * sideScale));
+	return scaled;
+}
+
+//------------------------------------------------------------------------------
+GeneratedMapStats GenerateMap(const MapGeneratorConfig& config, const std::string& filePath, const std::string& dataDirectory)
+{
+	constexpr uint32_t MIN_SIDE = START_CLEARANCE * 2 + 8;
+	if (config.mWidth < MIN_SIDE || config.mHeight < MIN_SIDE)
+	{
+		throw std::runtime_error("Generated maps must be at least " + std::to_string(MIN_SIDE) + " tiles a side");
+	}
+
+	MapLayout layout(config);
+	layout.Generate();
+
+	const fs::path outputPath(filePath);
+	if (outputPath.has_parent_path())
+	{
+		fs::create_directories(outputPath.parent_path());
+	}
+	std::ofstream stream(outputPath, std::ios::out | std::ios::trunc);
+	if (!stream)
+	{
+		throw std::runtime_error("Failed to open file: " + filePath);
+	}
+
+	// Tileson resolves tileset and image paths relative to the map file
+	const fs::path mapDirectory = fs::absolute(outputPath).parent_path();
+	const std::string tilesetDirectory = fs::relative(fs::absolute(dataDirectory) / "Tilesets", mapDirectory).generic_string();
+	const std::string graphicsDirectory = fs::relative(fs::absolute(dataDirectory) / ".." / "graphics", mapDirectory).generic_string();
+
+	stream << "{\"compressionlevel\":-1,\"height\":" << config.mHeight << ",\"infinite\":false,\"layers\":[";
+
+	TiledJsonWriter writer(stream, config);
+	auto gidWhere = [&layout](CellKind kind, uint32_t gid) {
+		return [&layout, kind, gid](uint32_t index) { return layout.Get(index) == kind ? gid : 0; };
+	};
+
+	writer.WriteTileLayer("Water", gidWhere(CellKind::Water, WATER_ANIMATION_GID));
+	writer.WriteTileLayer("Ground", [&layout](uint32_t index) { return layout.Get(index) == CellKind::Water ? 0 : GRASS_GID; });
+	for (size_t layer = 0; layer < layout.GetDetailLayers().size(); layer++)
+	{
+		const std::vector<uint32_t>& details = layout.GetDetailLayers()[layer];
+		writer.WriteTileLayer("Detail " + std::to_string(layer + 1), [&details](uint32_t index) { return details[index]; });
+	}
+	writer.WriteTileLayer("Hills", gidWhere(CellKind::Blocked, HILL_GID));
+
+	// Layers Level reads but the generator leaves empty
+	for (const char* layerName : { "Fence", "HouseFloor", "HouseWalls", "HouseFurnitureBottom", "HouseFurnitureTop" })
+	{
+		writer.BeginObjectLayer(layerName);
+		writer.EndObjectLayer();
+	}
+
+	writer.BeginObjectLayer("Trees");
+	for (const PlacedObject& tree : layout.GetTrees())
+	{
+		writer.WriteTileObject(tree);
+	}
+	writer.EndObjectLayer();
+
+	writer.BeginObjectLayer("Decoration");
+	for (const PlacedObject& flower : layout.GetFlowers())
+	{
+		writer.WriteTileObject(flower);
+	}
+	writer.EndObjectLayer();
+
+	// The start and its interactions share the cleared square
+	const float tile = static_cast<float>(TILESIZE);
+	const float startX = layout.GetStartX() * tile;
+	const float startY = layout.GetStartY() * tile;
+	writer.BeginObjectLayer("Player");
+	writer.WriteRectObject("Start", startX + tile * 0.5f, startY + tile * 0.5f, 0.0f, 0.0f, true);
+	writer.WriteRectObject("Bed", startX - START_CLEARANCE * tile, startY - START_CLEARANCE * tile, tile, tile);
+	writer.WriteRectObject("Trader", startX + tile, startY - START_CLEARANCE * tile, tile * 2.0f, tile);
+	writer.EndObjectLayer();
+
+	writer.WriteTileLayer("Collision", [&layout](uint32_t index) {
+		const CellKind kind = layout.Get(index);
+		return kind == CellKind::Blocked || kind == CellKind::Water ? COLLISION_GID : 0;
+	});
+	writer.WriteTileLayer("Farmable", gidWhere(CellKind::Farmable, FARMABLE_GID));
+
+	stream << "],\"nextlayerid\":" << writer.GetLayerCount() + 1
+		   << ",\"nextobjectid\":" << writer.GetObjectCount() + 1
+		   << ",\"orientation\":\"orthogonal\""
+		   << ",\"properties\":[{\"name\":\"rainChance\",\"type\":\"int\",\"value\":" << config.mRainChance << "}]"
+		   << ",\"renderorder\":\"right-down\",\"tiledversion\":\"1.10.2\",\"tileheight\":" << TILESIZE << ",\"tilesets\":[";
+	for (const TilesetReference& tileset : TILESETS)
+	{
+		stream << "{\"firstgid\":" << tileset.mFirstGid << ",\"source\":\"" << tilesetDirectory << "/" << tileset.mFileName << "\"},";
+	}
+	stream << "{\"columns\":4,\"firstgid\":" << WATER_ANIMATION_GID
+		   << ",\"image\":\"" << graphicsDirectory << "/water/water_spritesheet.png\",\"imageheight\":64,\"imagewidth\":256"
+		   << ",\"margin\":0,\"name\":\"Water Animation\",\"spacing\":0,\"tilecount\":4,\"tileheight\":64"
+		   << ",\"tiles\":[{\"animation\":[{\"duration\":250,\"tileid\":0},{\"duration\":250,\"tileid\":1}"
+		   << ",{\"duration\":250,\"tileid\":2},{\"duration\":250,\"tileid\":3}],\"id\":0}],\"tilewidth\":64}";
+	stream << "],\"tilewidth\":" << TILESIZE << ",\"type\":\"map\",\"version\":\"1.10\",\"width\":" << config.mWidth << "}";
+
+	if (!stream)
+	{
+		throw std::runtime_error("Failed to write file: " + filePath);
+	}
+
+	GeneratedMapStats stats;
+	stats.mTileCount = config.mWidth * config.mHeight;
+	stats.mLayerCount = writer.GetLayerCount();
+	stats.mWaterTiles = layout.Count(CellKind::Water);
+	stats.mCollisionTiles = layout.Count(CellKind::Blocked) + stats.mWaterTiles;
+	stats.mFarmableTiles = layout.Count(CellKind::Farmable);
+	stats.mTreeCount = static_cast<uint32_t>(layout.GetTrees().size());
+	stats.mFlowerCount = static_cast<uint32_t>(layout.GetFlowers().size());
+	return stats;
+}
+
+//------------------------------------------------------------------------------
+std::string GenerateScenarioMap(const MapScenario& scenario, uint32_t areaScale, GeneratedMapStats* outStats)
+{
+	const std::string filePath = std::string(GENERATED_MAP_DIRECTORY) + "/" + scenario.mName + "_x" + std::to_string(areaScale) + ".json";
+	const GeneratedMapStats stats = GenerateMap(ScaleMapConfig(scenario.mConfig, areaScale), filePath);
+	if (outStats)
+	{
+		*outStats = stats;
+	}
+	return filePath;
+}
+
+//------------------------------------------------------------------------------
+std::string GetScenarioMapId(const MapScenario& scenario, uint32_t areaScale)
+{
+	return scenario.mName + "@" + std::to_string(areaScale);
+}
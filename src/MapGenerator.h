@@ -0,0 +1,72 @@
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+// Game
+#include "Settings.h"
+
+// System
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Shape of a generated map. Densities are the chance a free tile receives the
+// item, fractions the share of all tiles to cover
+struct MapGeneratorConfig
+{
+	uint32_t mWidth{ 50 };				// tiles
+	uint32_t mHeight{ 40 };
+	uint32_t mSeed{ 1 };
+	uint32_t mDetailLayerCount{ 2 };	// drawn tile layers of plant decoration
+	float mTreeDensity{ 0.03f };
+	float mFlowerDensity{ 0.04f };
+	float mCollisionFraction{ 0.04f };	// rocks, on top of the border and water
+	float mWaterFraction{ 0.1f };		// animated tiles
+	float mFarmableFraction{ 0.15f };
+	int32_t mRainChance{ RAIN_CHANCE };	// written as the map's rainChance property
+};
+
+//------------------------------------------------------------------------------
+struct GeneratedMapStats
+{
+	uint32_t mTileCount{ 0 };
+	uint32_t mLayerCount{ 0 };
+	uint32_t mWaterTiles{ 0 };
+	uint32_t mCollisionTiles{ 0 };
+	uint32_t mFarmableTiles{ 0 };
+	uint32_t mTreeCount{ 0 };
+	uint32_t mFlowerCount{ 0 };
+};
+
+//------------------------------------------------------------------------------
+struct MapScenario
+{
+	std::string mName;
+	std::string mDescription;
+	MapGeneratorConfig mConfig; // at an area scale of 1
+};
+
+// Predefined stress scenarios shared by the generator tool, headless host and benchmarks
+const std::vector<MapScenario>& GetMapScenarios();
+const MapScenario* FindMapScenario(const std::string& name);
+
+// Multiplies the map's area, keeping its aspect ratio and densities
+MapGeneratorConfig ScaleMapConfig(const MapGeneratorConfig& config, uint32_t areaScale);
+
+//------------------------------------------------------------------------------
+/**
+ * Writes a Tiled JSON map with every layer Level expects, referencing the
+ * tilesets in dataDirectory by a path relative to the map so it also opens in
+ * Tiled. The same config and seed always produce the same map.
+ *
+ * Throws std::runtime_error when the file cannot be written.
+ */
+GeneratedMapStats GenerateMap(const MapGeneratorConfig& config, const std::string& filePath,
+							  const std::string& dataDirectory = MAP_DATA_DIRECTORY);
+
+// Generates the scenario into GENERATED_MAP_DIRECTORY and returns the file path
+std::string GenerateScenarioMap(const MapScenario& scenario, uint32_t areaScale, GeneratedMapStats* outStats = nullptr);
+
+// Asset id for a scenario map, e.g. "dense-forest@16"
+std::string GetScenarioMapId(const MapScenario& scenario, uint32_t areaScale);
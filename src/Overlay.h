@@ -2,56 +2,191 @@
 
 #include <SFML/Graphics.hpp>
 
+#include <array>
+#include <cstdio>
+
 #include "Core/AssetManager.h"
+#include "Core/Font.h"
 #include "Core/RectUtils.h"
+#include "Core/Render/RenderCommandList.h"
 #include "Core/Texture.h"
+#include "Core/Text/TextBatch.h"
 
 #include "Player.h"
 #include "Settings.h"
 
+// Numbers shown on the HUD debug line
+struct HudStats
+{
+	sf::Time mFrameTime;
+	uint32_t mSpriteCount;
+	uint32_t mActiveVoices;
+};
+
+/**
+ * Tool and seed icons, inventory counts, the time of day and a debug line.
+ * Everything is composed into a render texture that is only redrawn when
+ * something shown has changed, every other frame draws a single quad.
+ */
 class Overlay : public IPlayerObserver
 {
 public:
-	Overlay(AssetManager& assetManager, Player& player)
+	Overlay(AssetManager& assetManager, Player& player, const sf::Vector2u& size)
 		: mAssetManager(assetManager),
 		  mPlayer(player),
-		  mToolSprite(assetManager.GetAsset<Texture>(player.GetActiveTool()).GetRawTexture()),
-		  mSeedSprite(assetManager.GetAsset<Texture>(player.GetActiveSeed()).GetRawTexture())
+		  mToolTexture(assetManager.AcquireAsset<Texture>(player.GetActiveTool())),
+		  mSeedTexture(assetManager.AcquireAsset<Texture>(player.GetActiveSeed())),
+		  mToolSprite(mToolTexture->GetRawTexture()),
+		  mSeedSprite(mSeedTexture->GetRawTexture()),
+		  mHudFont(assetManager.AcquireAsset<Font>("hud")),
+		  mDebugFont(assetManager.AcquireAsset<Font>("debug")),
+		  mText(mHudFont->GetRawFont()),
+		  mDebugText(mDebugFont->GetRawFont()),
+		  mCacheSprite(mCache.getTexture())
 	{
-		SetOverlayTexture(player.GetActiveTool(), "tool", mToolSprite);
-		SetOverlayTexture(player.GetActiveSeed(), "seed", mSeedSprite);
+		SetOverlayTexture(player.GetActiveTool(), "tool", mToolTexture, mToolSprite);
+		SetOverlayTexture(player.GetActiveSeed(), "seed", mSeedTexture, mSeedSprite);
+
+		mText.PreloadGlyphs(HUD_TEXT_SIZE, HUD_CHARACTERS);
+		mDebugText.PreloadGlyphs(HUD_DEBUG_TEXT_SIZE, HUD_CHARACTERS);
+		for (size_t index = 0; index < INVENTORY_ITEMS.size(); index++)
+		{
+			mInventoryText[index] = mText.Add(HUD_TEXT_SIZE, sf::Vector2f(20.0f, 10.0f + index * HUD_LINE_HEIGHT));
+		}
+		mClockText = mText.Add(HUD_TEXT_SIZE, sf::Vector2f()); // right aligned by Resize
+		mDebugLine = mDebugText.Add(HUD_DEBUG_TEXT_SIZE, sf::Vector2f(20.0f, 10.0f + INVENTORY_ITEMS.size() * HUD_LINE_HEIGHT));
+		mDebugText.SetVisible(mDebugLine, HUD_DEBUG_STATS);
+
+		Resize(size);
+		InventoryChanged();
 		player.Subscribe(this);
 	}
 
-	void Draw(sf::RenderWindow& window)
+	void SetTimeOfDay(uint32_t minuteOfDay)
+	{
+		if (minuteOfDay != mMinuteOfDay)
+		{
+			char buffer[8];
+			const int length = std::snprintf(buffer, sizeof(buffer), "%02u:%02u", minuteOfDay / 60, minuteOfDay % 60);
+			mText.SetText(mClockText, std::string_view(buffer, length));
+			mMinuteOfDay = minuteOfDay;
+		}
+	}
+
+	void SetDebugStats(const HudStats& stats)
+	{
+		char buffer[96];
+		const int length = std::snprintf(buffer, sizeof(buffer), "frame %.1f ms   sprites %u   voices %u",
+										 stats.mFrameTime.asSeconds() * 1000.0f, stats.mSpriteCount, stats.mActiveVoices);
+		mDebugText.SetText(mDebugLine, std::string_view(buffer, length));
+	}
+
+	void Resize(const sf::Vector2u& size)
+	{
+		if (!mCache.create(size))
+		{
+			throw std::runtime_error("Failed to create the HUD texture");
+		}
+		mCacheSprite.setTexture(mCache.getTexture(), true);
+		mText.SetPosition(mClockText, sf::Vector2f(static_cast<float>(size.x) - HUD_CLOCK_WIDTH, 10.0f));
+		mIsDirty = true;
+	}
+
+	// Redraws the cache here, before the list referencing it is handed to the render thread
+	void Draw(RenderCommandList& commands)
 	{
-		window.draw(mToolSprite);
-		window.draw(mSeedSprite);
+		if (mIsDirty || mText.IsDirty() || mDebugText.IsDirty())
+		{
+			Redraw();
+		}
+
+		// The cache holds alpha premultiplied colors, blending them again would darken edges
+		commands.draw(mCacheSprite, sf::RenderStates(sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha)));
 	}
 
+	// Getters
+	uint32_t GetRedrawCount() const { return mRedrawCount; }
+
 private:
+	static constexpr uint32_t HUD_TEXT_SIZE = 28;
+	static constexpr uint32_t HUD_DEBUG_TEXT_SIZE = 16;
+	static constexpr float HUD_LINE_HEIGHT = 32.0f;
+	static constexpr float HUD_CLOCK_WIDTH = 100.0f;
+	static constexpr const char* HUD_CHARACTERS = "0123456789:. abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+	// Inventory key and label
+	static constexpr std::array<std::pair<const char*, const char*>, 4> INVENTORY_ITEMS = { {
+		{ "wood", "Wood" },
+		{ "apple", "Apple" },
+		{ "corn", "Corn" },
+		{ "tomoato", "Tomato" }
+	} };
+
+	void Redraw()
+	{
+		mCache.clear(sf::Color::Transparent);
+		mCache.draw(mToolSprite);
+		mCache.draw(mSeedSprite);
+		mCache.draw(mText);
+		mCache.draw(mDebugText);
+		mCache.display();
+		mIsDirty = false;
+		mRedrawCount++;
+	}
+
 	// IPlayerObserver interface
 	void ToolChanged(const std::string& tool) override
 	{
-		SetOverlayTexture(tool, "tool", mToolSprite);
+		SetOverlayTexture(tool, "tool", mToolTexture, mToolSprite);
 	}
 
 	void SeedChanged(const std::string& seed) override
 	{
-		SetOverlayTexture(seed, "seed", mSeedSprite);
+		SetOverlayTexture(seed, "seed", mSeedTexture, mSeedSprite);
+	}
+
+	void InventoryChanged() override
+	{
+		const std::map<std::string, int32_t>& inventory = mPlayer.GetInventory();
+		for (size_t index = 0; index < INVENTORY_ITEMS.size(); index++)
+		{
+			auto it = inventory.find(INVENTORY_ITEMS[index].first);
+			char buffer[32];
+			const int length = std::snprintf(buffer, sizeof(buffer), "%s %d", INVENTORY_ITEMS[index].second, it != inventory.end() ? it->second : 0);
+			mText.SetText(mInventoryText[index], std::string_view(buffer, length));
+		}
 	}
 
-	void SetOverlayTexture(const std::string& textureId, const std::string& overlayId, sf::Sprite& sprite)
+	void SetOverlayTexture(const std::string& textureId, const std::string& overlayId, AssetHandle<Texture>& handle, sf::Sprite& sprite)
 	{
-		const sf::Texture& texture = mAssetManager.GetAsset<Texture>(textureId).GetRawTexture();
-		sprite.setTexture(texture, true);
+		// Hold the new texture before releasing the previous one
+		AssetHandle<Texture> texture = mAssetManager.AcquireAsset<Texture>(textureId);
+		sprite.setTexture(texture->GetRawTexture(), true);
+		handle = std::move(texture);
 		sprite.setOrigin(GetRectMidBottom(sprite.getLocalBounds()));
 		sprite.setPosition(OVERLAY_POSITIONS.at(overlayId));
+		mIsDirty = true;
 	}
 
 private:
 	AssetManager& mAssetManager;
 	Player& mPlayer;
+	AssetHandle<Texture> mToolTexture; // released on switch so unused icons can be evicted
+	AssetHandle<Texture> mSeedTexture;
 	sf::Sprite mToolSprite;
 	sf::Sprite mSeedSprite;
-};
\ No newline at end of file
+
+	AssetHandle<Font> mHudFont;
+	AssetHandle<Font> mDebugFont;
+	TextBatch mText;
+	TextBatch mDebugText;
+	std::array<TextId, INVENTORY_ITEMS.size()> mInventoryText;
+	TextId mClockText;
+	TextId mDebugLine;
+	uint32_t mMinuteOfDay{ UINT32_MAX };
+
+	sf::RenderTexture mCache;
+	sf::Sprite mCacheSprite;
+	bool mIsDirty{ true };
+	uint32_t mRedrawCount{ 0 };
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <unordered_map>
 #include <vector>
@@ -13,6 +14,12 @@
 #include "Core/AssetManager.h"
 #include "Core/Animation/AnimationPlayer.h"
 #include "Core/RectUtils.h"
+#include "Core/BinaryStream.h"
+#include "Core/Input/InputSystem.h"
+#include "Core/Collision/StaticCollisionMap.h"
+#include "Core/Collision/RectBatch.h"
+#include "Core/Scene.h"
+#include "Core/TimerWheel.h"
 
 #include "Settings.h"
 #include "Sprites.h"
@@ -25,7 +32,24 @@ enum class TimerId
 	TOOL_USE = 0,
 	TOOL_SWITCH = 1,
 	SEED_USE = 2,
-	SEED_SWITCH = 3
+	SEED_SWITCH = 3,
+	COUNT = 4
+};
+
+// --------------------------------------------------------------------------------
+// Snapshot record, the status string and inventory follow it in the stream
+struct PlayerState
+{
+	float mHitboxLeft;
+	float mHitboxTop;
+	float mDirectionX;
+	float mDirectionY;
+	float mTimerRemaining[4]; // seconds, indexed by TimerId
+	uint8_t mTimerActive[4];
+	uint8_t mToolIndex;
+	uint8_t mSeedIndex;
+	uint8_t mIsAsleep;
+	uint8_t mPadding;
 };
 
 // --------------------------------------------------------------------------------
@@ -34,6 +58,9 @@ class IPlayerObserver
 public:
 	virtual void ToolChanged(const std::string& tool) { }
 	virtual void SeedChanged(const std::string& seed) { }
+	virtual void ToolUsed(const std::string& tool) { }
+	virtual void SeedUsed(const std::string& seed) { }
+	virtual void InventoryChanged() { }
 	virtual void WentToSleep() { }
 };
 
@@ -43,7 +70,7 @@ class PlayerSubject
 public:
 	void Subscribe(IPlayerObserver* observer) { mObservers.emplace_back(observer); }
 
-	void NotifyToolChanged(std::string tool)
+	void NotifyToolChanged(const std::string& tool)
 	{
 		for (auto& observer : mObservers)
 		{
@@ -51,7 +78,7 @@ public:
 		}
 	}
 
-	void NotifySeedChanged(std::string seed)
+	void NotifySeedChanged(const std::string& seed)
 	{
 		for (auto& observer : mObservers)
 		{
@@ -59,6 +86,30 @@ public:
 		}
 	}
 
+	void NotifyToolUsed(const std::string& tool)
+	{
+		for (auto& observer : mObservers)
+		{
+			observer->ToolUsed(tool);
+		}
+	}
+
+	void NotifySeedUsed(const std::string& seed)
+	{
+		for (auto& observer : mObservers)
+		{
+			observer->SeedUsed(seed);
+		}
+	}
+
+	void NotifyInventoryChanged()
+	{
+		for (auto& observer : mObservers)
+		{
+			observer->InventoryChanged();
+		}
+	}
+
 	void NotifyWentToSleep()
 	{
 		for (auto& observer : mObservers)
@@ -75,13 +126,17 @@ private:
 class Player : public Sprite, public PlayerSubject
 {
 public:
-	Player(AssetManager& assetManager, const sf::Vector2f& position, Group& collisionSprites, 
+	Player(AssetManager& assetManager, const InputSystem& input, const sf::Vector2f& position,
+		   const StaticCollisionMap& staticCollision, Group& collisionSprites,
 		   Group& treeSprites, Group& interactionSprites, SoilLayer& soilLayer, uint16_t depth)
-		: mCollisionSprites(collisionSprites),
+		: mInput(input),
+		  mStaticCollision(staticCollision),
+		  mCollisionSprites(collisionSprites),
 		  mInteractionSprites(interactionSprites),
 		  mTreeSprites(treeSprites),
 		  mSoilLayer(soilLayer),
-		  mAnimationPlayer(assetManager.GetAsset<Animation>("character")),
+		  mAnimation(assetManager.AcquireAsset<Animation>("character")),
+		  mAnimationPlayer(mAnimation.Get()),
 		  mSpeed(300),
 		  mStatus("down_idle"),
 		  mToolPicker({ "hoe", "axe", "water"}),
@@ -93,10 +148,7 @@ public:
 		SetPosition(position);
 		SetOrigin(sf::Vector2f(0.5f, 0.5f));
 
-		mTimers.emplace(TimerId::TOOL_USE, Timer(sf::milliseconds(350), std::bind(&Player::UseTool, this)));
-		mTimers.emplace(TimerId::TOOL_SWITCH, Timer(sf::milliseconds(200)));
-		mTimers.emplace(TimerId::SEED_USE, Timer(sf::milliseconds(350), std::bind(&Player::UseSeed, this)));
-		mTimers.emplace(TimerId::SEED_SWITCH, Timer(sf::milliseconds(200)));
+		mTimerDurations = { sf::milliseconds(350), sf::milliseconds(200), sf::milliseconds(350), sf::milliseconds(200) };
 			
 		mHitbox = InflateRect(GetGlobalBounds(), -127, -70);
 
@@ -109,6 +161,14 @@ public:
 		};
 	}
 
+	~Player()
+	{
+		for (TimerHandle& handle : mTimers)
+		{
+			GetScene().GetTimerWheel().Cancel(handle);
+		}
+	}
+
 	virtual sf::FloatRect GetLocalBoundsInternal() const override
 	{
 		return mAnimationPlayer.GetSprite().getLocalBounds();
@@ -125,16 +185,21 @@ public:
 	}
 
 	uint16_t GetDepth() const override { return mDepth; }
-	std::string GetActiveTool() const { return mToolPicker.GetItem(); }
-	std::string GetActiveSeed() const { return mSeedPicker.GetItem(); }
+	UpdateFrequency GetUpdateFrequency() const override { return UpdateFrequency::EveryTick; }
+	const std::string& GetActiveTool() const { return mToolPicker.GetItem(); }
+	const std::string& GetActiveSeed() const { return mSeedPicker.GetItem(); }
 
-	void AddItemToInventory(const std::string& item)
+	const std::map<std::string, int32_t>& GetInventory() const { return mInventory; }
+
+	// Callers adding a batch notify observers once, after the last item
+	void AddItemToInventory(const std::string& item, int32_t count = 1)
 	{
-		mInventory.at(item)++;
+		mInventory.at(item) += count;
 	}
 
 	void UseTool()
     {		
+		NotifyToolUsed(mToolPicker.GetItem());
 		if (mToolPicker.GetItem() == "hoe")
 		{
 			mSoilLayer.HoeSoil(mTargetPosition);
@@ -161,20 +226,20 @@ public:
 
 	void UseSeed()
 	{
-		std::cout << mSeedPicker.GetItem() << std::endl;
+		NotifySeedUsed(mSeedPicker.GetItem());
 	}
 
 	void Input()
 	{
-		if (!mTimers[TimerId::TOOL_USE].IsActive() && !mIsAsleep)
+		if (!IsTimerActive(TimerId::TOOL_USE) && !mIsAsleep)
 		{
 			// directions
-			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up))
+			if (mInput.IsDown(Action::MOVE_UP))
 			{
 				mDirection.y = -1;
 				mStatus = "up";
 			}
-			else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down))
+			else if (mInput.IsDown(Action::MOVE_DOWN))
 			{
 				mDirection.y = 1;
 				mStatus = "down";
@@ -184,12 +249,12 @@ public:
 				mDirection.y = 0;
 			}
 
-			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right))
+			if (mInput.IsDown(Action::MOVE_RIGHT))
 			{
 				mDirection.x = 1;
 				mStatus = "right";
 			}
-			else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left))
+			else if (mInput.IsDown(Action::MOVE_LEFT))
 			{
 				mDirection.x = -1;
 				mStatus = "left";
@@ -200,37 +265,37 @@ public:
 			}
 
 			// tool use
-			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Space))
+			if (mInput.IsDown(Action::USE_TOOL))
 			{
-				mTimers[TimerId::TOOL_USE].Start();
+				StartTimer(TimerId::TOOL_USE);
 				mDirection = sf::Vector2f();
 			}
 
 			// change tool
-			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Q) && !mTimers[TimerId::TOOL_SWITCH].IsActive())
+			if (mInput.IsDown(Action::SWITCH_TOOL) && !IsTimerActive(TimerId::TOOL_SWITCH))
 			{
-				mTimers[TimerId::TOOL_SWITCH].Start();
+				StartTimer(TimerId::TOOL_SWITCH);
 				mToolPicker.Next();
 				NotifyToolChanged(mToolPicker.GetItem());
 			}
 
 			// seed use
-			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl))
+			if (mInput.IsDown(Action::USE_SEED))
 			{
-				mTimers[TimerId::SEED_USE].Start();
+				StartTimer(TimerId::SEED_USE);
 				mDirection = sf::Vector2f();
 			}
 
 			// change seed
-			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::E) && !mTimers[TimerId::SEED_SWITCH].IsActive())
+			if (mInput.IsDown(Action::SWITCH_SEED) && !IsTimerActive(TimerId::SEED_SWITCH))
 			{
-				mTimers[TimerId::SEED_SWITCH].Start();
+				StartTimer(TimerId::SEED_SWITCH);
 				mSeedPicker.Next();
 				NotifySeedChanged(mSeedPicker.GetItem());
 			}
 
 			// Sleep
-			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Enter))
+			if (mInput.IsDown(Action::SLEEP))
 			{								
 				for (GameObject* gameObject : mInteractionSprites)
 				{
@@ -263,64 +328,88 @@ public:
 
 	void GetStatus()
 	{
+		// Edited in place, the direction is always the first token, so the
+		// status string's capacity is reused every tick
+
 		// idle
 		if (mDirection.lengthSq() == 0)
 		{
-			mStatus = SplitAndGetElement(mStatus, '_', 0) + "_idle";
+			mStatus.resize(SplitAndGetElementView(mStatus, '_', 0).size());
+			mStatus += "_idle";
 		}
 
 		// tool use
-		if (mTimers[TimerId::TOOL_USE].IsActive())
+		if (IsTimerActive(TimerId::TOOL_USE))
 		{
-			mStatus = SplitAndGetElement(mStatus, '_', 0) + "_" + mToolPicker.GetItem();
+			mStatus.resize(SplitAndGetElementView(mStatus, '_', 0).size());
+			mStatus += '_';
+			mStatus += mToolPicker.GetItem();
 		}
 	}
 
-	void UpdateTimers(const sf::Time& timestamp)
+	bool IsTimerActive(TimerId id)
 	{
-		for (auto& pair : mTimers) {
-			pair.second.Update(timestamp);
-			if (pair.second.IsFinished())
-			{
-				pair.second.Reset();
-			}
+		return GetScene().GetTimerWheel().IsPending(mTimers[static_cast<size_t>(id)]);
+	}
+
+	void StartTimer(TimerId id)
+	{
+		StartTimer(id, mTimerDurations[static_cast<size_t>(id)]);
+	}
+
+	void StartTimer(TimerId id, const sf::Time& delay)
+	{
+		if (IsTimerActive(id))
+		{
+			return;
 		}
+
+		TimerWheel::Callback callback;
+		if (id == TimerId::TOOL_USE) { callback = [this]() { UseTool(); }; }
+		if (id == TimerId::SEED_USE) { callback = [this]() { UseSeed(); }; }
+		mTimers[static_cast<size_t>(id)] = GetScene().GetTimerWheel().Schedule(delay, std::move(callback));
 	}
 
-	void HortCollision()
+	// Dynamic collider hitboxes are gathered once per move, both axes scan the batch
+	void GatherColliders()
 	{
+		mColliderHitboxes.Clear();
 		for (GameObject* gameObject : mCollisionSprites)
 		{
-			const sf::FloatRect& targetHitbox = static_cast<Sprite*>(gameObject)->GetHitbox();
-			if (mHitbox.findIntersection(targetHitbox))
+			mColliderHitboxes.Add(static_cast<Sprite*>(gameObject)->GetHitbox());
+		}
+	}
+
+	void HortCollision()
+	{
+		for (size_t index = mColliderHitboxes.FindFirstOverlap(mHitbox); index != RectBatch::NONE;
+			 index = mColliderHitboxes.FindFirstOverlap(mHitbox, index + 1))
+		{
+			const sf::FloatRect targetHitbox = mColliderHitboxes.Get(index);
+			if (mDirection.x > 0)
 			{
-				if (mDirection.x > 0)
-				{
-					mHitbox.left = targetHitbox.left - mHitbox.width;
-				}
-				else if (mDirection.x < 0)
-				{
-					mHitbox.left = targetHitbox.left + targetHitbox.width;
-				}
+				mHitbox.left = targetHitbox.left - mHitbox.width;
+			}
+			else if (mDirection.x < 0)
+			{
+				mHitbox.left = targetHitbox.left + targetHitbox.width;
 			}
 		}
 	}
 
 	void VertCollision()
 	{
-		for (GameObject* gameObject : mCollisionSprites)
+		for (size_t index = mColliderHitboxes.FindFirstOverlap(mHitbox); index != RectBatch::NONE;
+			 index = mColliderHitboxes.FindFirstOverlap(mHitbox, index + 1))
 		{
-			const sf::FloatRect& targetHitbox = static_cast<Sprite*>(gameObject)->GetHitbox();
-			if (mHitbox.findIntersection(targetHitbox))
+			const sf::FloatRect targetHitbox = mColliderHitboxes.Get(index);
+			if (mDirection.y > 0)
 			{
-				if (mDirection.y > 0)
-				{
-					mHitbox.top = targetHitbox.top - mHitbox.height;
-				}
-				else if (mDirection.y < 0)
-				{
-					mHitbox.top = targetHitbox.top + targetHitbox.height;
-				}
+				mHitbox.top = targetHitbox.top - mHitbox.height;
+			}
+			else if (mDirection.y < 0)
+			{
+				mHitbox.top = targetHitbox.top + targetHitbox.height;
 			}
 		}
 	}
@@ -334,10 +423,12 @@ public:
 
 		sf::Vector2f positionDelta = mDirection * mSpeed * timestamp.asSeconds();
 		
-		mHitbox.left += positionDelta.x;
+		// Static geometry stops the move, dynamic colliders push the hitbox back out
+		GatherColliders();
+		mHitbox.left += mStaticCollision.SweepX(mHitbox, positionDelta.x);
 		HortCollision();
 		
-		mHitbox.top += positionDelta.y;
+		mHitbox.top += mStaticCollision.SweepY(mHitbox, positionDelta.y);
 		VertCollision();
 
 		sf::Vector2f center = GetRectCenter(mHitbox);
@@ -346,15 +437,21 @@ public:
 
 	void Animate(const sf::Time& timestamp)
 	{
+		const sf::Vector2f frameSize = GetLocalBoundsInternal().getSize();
 		mAnimationPlayer.SetAnimationSequence(mStatus);
 		mAnimationPlayer.Upate(timestamp);
+
+		// Origin is relative to the frame, so a differently sized frame moves the bounds
+		if (GetLocalBoundsInternal().getSize() != frameSize)
+		{
+			InvalidateTransform();
+		}
 	}
 
 	void Update(const sf::Time& timestamp) override
 	{
 		Input();
 		GetStatus();
-		UpdateTimers(timestamp);
 		Move(timestamp);
 		UpdateTargetPosition();
 		Animate(timestamp);
@@ -362,11 +459,84 @@ public:
 
 	const sf::Vector2f& GetTargetPosition() const { return mTargetPosition; }
 
+	void SaveState(BinaryWriter& writer)
+	{
+		PlayerState state{};
+		state.mHitboxLeft = mHitbox.left;
+		state.mHitboxTop = mHitbox.top;
+		state.mDirectionX = mDirection.x;
+		state.mDirectionY = mDirection.y;
+		TimerWheel& timerWheel = GetScene().GetTimerWheel();
+		for (size_t id = 0; id < mTimers.size(); id++)
+		{
+			state.mTimerRemaining[id] = timerWheel.GetRemaining(mTimers[id]).asSeconds();
+			state.mTimerActive[id] = timerWheel.IsPending(mTimers[id]);
+		}
+		state.mToolIndex = static_cast<uint8_t>(mToolPicker.GetIndex());
+		state.mSeedIndex = static_cast<uint8_t>(mSeedPicker.GetIndex());
+		state.mIsAsleep = mIsAsleep;
+
+		writer.Write(state);
+		writer.WriteString(mStatus);
+
+		writer.Write(static_cast<uint32_t>(mInventory.size()));
+		for (const auto& pair : mInventory)
+		{
+			writer.Write(pair.second);
+		}
+	}
+
+	void RestoreState(BinaryReader& reader)
+	{
+		PlayerState state = reader.Read<PlayerState>();
+		reader.ReadString(mStatus);
+
+		if (reader.Read<uint32_t>() != mInventory.size())
+		{
+			throw std::runtime_error("Player snapshot does not match the inventory layout");
+		}
+		for (auto& pair : mInventory)
+		{
+			pair.second = reader.Read<int32_t>();
+		}
+
+		mHitbox.left = state.mHitboxLeft;
+		mHitbox.top = state.mHitboxTop;
+		mDirection = sf::Vector2f(state.mDirectionX, state.mDirectionY);
+		for (size_t id = 0; id < mTimers.size(); id++)
+		{
+			GetScene().GetTimerWheel().Cancel(mTimers[id]);
+			if (state.mTimerActive[id])
+			{
+				StartTimer(static_cast<TimerId>(id), sf::seconds(state.mTimerRemaining[id]));
+			}
+		}
+		mIsAsleep = state.mIsAsleep != 0;
+
+		if (mToolPicker.GetIndex() != state.mToolIndex)
+		{
+			mToolPicker.SetIndex(state.mToolIndex);
+			NotifyToolChanged(mToolPicker.GetItem());
+		}
+		if (mSeedPicker.GetIndex() != state.mSeedIndex)
+		{
+			mSeedPicker.SetIndex(state.mSeedIndex);
+			NotifySeedChanged(mSeedPicker.GetItem());
+		}
+		NotifyInventoryChanged();
+
+		sf::Vector2f center = GetRectCenter(mHitbox);
+		SetPosition(sf::Vector2f(static_cast<int32_t>(center.x), static_cast<int32_t>(center.y)));
+		mAnimationPlayer.SetAnimationSequence(mStatus);
+		InvalidateTransform();
+		UpdateTargetPosition();
+	}
+
 private:
 	void UpdateTargetPosition()
 	{
 		const sf::FloatRect globalBounds = GetGlobalBounds();
-		mTargetPosition = globalBounds.getCenter() + PLAYER_TOOL_OFFSET.at(SplitAndGetElement(mStatus, '_', 0));
+		mTargetPosition = globalBounds.getCenter() + PLAYER_TOOL_OFFSET.at(std::string(SplitAndGetElementView(mStatus, '_', 0)));
 	}
 
 	std::map<std::string, int32_t> mInventory;
@@ -375,12 +545,17 @@ private:
 	sf::Vector2f mDirection;
 	float mSpeed;
 	std::string mStatus;
+	AssetHandle<Animation> mAnimation;
 	AnimationPlayer mAnimationPlayer;
-	std::unordered_map<TimerId, Timer> mTimers;
+	std::array<TimerHandle, static_cast<size_t>(TimerId::COUNT)> mTimers;
+	std::array<sf::Time, static_cast<size_t>(TimerId::COUNT)> mTimerDurations;
 	std::string mSelectedTool;
 	ItemPicker<std::string> mToolPicker;
 	ItemPicker<std::string> mSeedPicker;
+	const InputSystem& mInput;
+	const StaticCollisionMap& mStaticCollision;
 	Group& mCollisionSprites;
+	RectBatch mColliderHitboxes;
 	Group& mInteractionSprites;
 	Group& mTreeSprites;
 	SoilLayer& mSoilLayer;
@@ -1,15 +1,83 @@
 #pragma once
 
+#include <array>
 #include <unordered_map>
 #include <vector>
 #include <string>
 
 #include <SFML/Graphics.hpp>
 
+#include "Core/QualityGovernor.h"
+
 constexpr char* CAPTION = "Stardew Valley";
 constexpr uint16_t WIDTH = 1280;
 constexpr uint16_t HEIGHT = 720;
 constexpr uint16_t TILESIZE = 64;
+constexpr const char* AUTOSAVE_FILE = "autosave.sav";
+
+// Composite runs of static tile layers into cached render texture chunks
+constexpr bool FLATTEN_STATIC_LAYERS = true;
+
+// Worker threads solving NPC path queries, 0 solves them on the game thread
+constexpr uint32_t PATHFINDING_WORKERS = 2;
+
+// Wandering villagers simulated by the crowd system
+constexpr uint32_t VILLAGER_COUNT = 24;
+
+// CPU plus estimated GPU bytes the asset manager keeps resident before it
+// evicts unreferenced assets, 0 keeps everything
+constexpr size_t ASSET_MEMORY_BUDGET = 192 * 1024 * 1024;
+
+// Chance of rain each day out of 10, maps may override it with a rainChance property
+constexpr int32_t RAIN_CHANCE = 3;
+
+// Generated stress maps reference the tilesets in the data directory
+constexpr const char* MAP_DATA_DIRECTORY = "../../data";
+constexpr const char* GENERATED_MAP_DIRECTORY = "../../data/generated";
+
+// In-game time, the clock restarts at dawn each day
+constexpr uint32_t DAY_START_MINUTE = 6 * 60;
+constexpr float GAME_MINUTES_PER_SECOND = 1.0f;
+
+// Night lighting, one light map cell per half tile. The ambient fades from day
+// to night over the dusk hours and back over the dawn hours
+constexpr float LIGHT_CELL_SIZE = TILESIZE / 2;
+constexpr uint32_t DUSK_START_MINUTE = 18 * 60;
+constexpr uint32_t DAWN_START_MINUTE = 5 * 60;
+constexpr uint32_t TWILIGHT_MINUTES = 2 * 60;
+constexpr float LANTERN_RADIUS = 3.5f * TILESIZE;
+constexpr float LAMP_RADIUS = 5 * TILESIZE;
+
+// HUD debug line, refreshed every few ticks so its texture is not redrawn every frame
+constexpr bool HUD_DEBUG_STATS = true;
+constexpr uint32_t HUD_STATS_INTERVAL = 15;
+
+// Simulation level of detail around the camera, see UpdateScheduler. The near
+// rings cover the view, sprites past the far rings sleep until woken
+constexpr float UPDATE_CELL_SIZE = 4 * TILESIZE;
+constexpr uint32_t UPDATE_NEAR_CELLS = 3;
+constexpr uint32_t UPDATE_FAR_CELLS = 6;
+
+// Per quality level settings, lowest first, see QualityGovernor
+constexpr std::array<float, QUALITY_LEVEL_COUNT> RAIN_DENSITY = { 0.25f, 0.5f, 1.0f };			// share of the full drop rate
+constexpr std::array<bool, QUALITY_LEVEL_COUNT> EFFECT_PARTICLES = { false, true, true };		// silhouette flashes
+constexpr std::array<uint32_t, QUALITY_LEVEL_COUNT> TILE_ANIMATION_INTERVAL = { 4, 2, 1 };		// ticks between map tile animation steps
+constexpr std::array<uint32_t, QUALITY_LEVEL_COUNT> OFFSCREEN_UPDATE_INTERVAL = { 8, 4, 2 };	// ticks between far band updates
+constexpr std::array<bool, QUALITY_LEVEL_COUNT> DEBUG_DRAWS = { false, false, true };			// hitboxes and player target
+
+// Player actions, bound to keys in Game::Create
+enum class Action : uint8_t
+{
+	MOVE_UP,
+	MOVE_DOWN,
+	MOVE_LEFT,
+	MOVE_RIGHT,
+	USE_TOOL,
+	SWITCH_TOOL,
+	USE_SEED,
+	SWITCH_SEED,
+	SLEEP
+};
 
 const extern std::unordered_map<std::string, sf::Vector2f> OVERLAY_POSITIONS;
 const extern std::unordered_map<std::string, uint16_t> LAYERS;
@@ -10,9 +10,13 @@
 #include <SFML/Graphics.hpp>
 
 // Core
-#include "Core/Timer.h"
+#include "Core/QualityGovernor.h"
+#include "Core/ResourceLocator.h"
+#include "Core/TimerWheel.h"
 #include "Core/Utils.h"
 #include "Core/Texture.h"
+#include "Core/Lighting/LightMap.h"
+#include "Core/Render/RenderCommandList.h"
 
 // --------------------------------------------------------------------------------
 class Drop : public Generic
@@ -21,52 +25,73 @@ public:
 	Drop(const sf::Texture& texture, const sf::IntRect& textureRegion,
 	     const sf::Vector2f& position, uint16_t depth, bool isMoving)
 		: Generic(texture, textureRegion, sf::Vector2f(), position, depth)
-        , mTimer(sf::milliseconds(RandomInteger(400, 500)))
+        , mDuration(sf::milliseconds(RandomInteger(400, 500)))
 		, mIsMoving(isMoving)
 		, mSpeed(static_cast<float>(RandomInteger(200, 250)))
 		, mDirection(-2, 4)
-	{         		
-        mTimer.Start();
+	{ }
+
+	~Drop()
+	{
+		GetScene().GetTimerWheel().Cancel(mTimer);
+	}
+
+	virtual void SetUp(Scene& scene) override
+	{
+		mTimer = scene.GetTimerWheel().Schedule(mDuration, [this]() { Kill(); });
 	}
 
 	virtual void Update(const sf::Time& timestamp)
 	{
-		mTimer.Update(timestamp);
-		
 		if (mIsMoving)
 		{			
 			Move(mDirection * mSpeed * timestamp.asSeconds());
 		}		
-		
-		if (mTimer.IsFinished())
-		{
-			Kill();
-			return;
-		}
 	};
 
 private:
-    Timer mTimer;
+    sf::Time mDuration;
+    TimerHandle mTimer;
 	bool mIsMoving;
 	float mSpeed;
 	sf::Vector2f mDirection;
 };
 
 // --------------------------------------------------------------------------------
-class Rain
+class Rain : public IQualityListener
 {
 public:
     Rain(Group& allSprites, Scene& scene)
         : mAllSprites(allSprites)
 		, mScene(scene)
-    { }
+		, mTextures(ResourceLocator::GetInstance().GetAssetManager())
+    {
+		ResourceLocator::GetInstance().GetQualityGovernor().AddListener(this);
+	}
+
+	~Rain()
+	{
+		ResourceLocator::GetInstance().GetQualityGovernor().RemoveListener(this);
+	}
 
     void Update(ViewRegion viewRegion)
     {
-		CreateFloor(viewRegion.GetScreenViewRegion());
-		CreateDrop(viewRegion.GetScreenViewRegion());
+		// Fractional densities carry over, so a quarter density spawns every fourth tick
+		mSpawnCredit += mDensity;
+		while (mSpawnCredit >= 1.0f)
+		{
+			CreateFloor(viewRegion.GetScreenViewRegion());
+			CreateDrop(viewRegion.GetScreenViewRegion());
+			mSpawnCredit -= 1.0f;
+		}
     }
 
+	// IQualityListener interface
+	virtual void OnQualityChanged(QualityLevel level) override
+	{
+		mDensity = SelectForQuality(RAIN_DENSITY, level);
+	}
+
 	void CreateFloor(const sf::FloatRect& screenViewRegion)
 	{
 		static std::vector<std::string> textureIds = { "floor_0", "floor_1", "floor_2" };
@@ -90,7 +115,7 @@ public:
 private:
 	void CreateSprite(const std::string& textureId, const sf::Vector2f& position, uint16_t depth, bool isMoving) 
 	{
-		sf::Texture& texture = GetTextureFromId(textureId);
+		sf::Texture& texture = mTextures.Get(textureId).GetRawTexture();
 		sf::IntRect textureRegion(sf::Vector2i(), sf::Vector2i(texture.getSize()));
 
 		GameObject* sprite = mScene.CreateGameObject<Drop>(texture, textureRegion, position, depth, isMoving);
@@ -104,14 +129,63 @@ private:
 		return screenViewRegion.getPosition() + sf::Vector2f(xOffset, yOffset);
 	}
 
-	sf::Texture& GetTextureFromId(const std::string& textureId) 
+	Group& mAllSprites;
+    Scene& mScene;
+	AssetHandleCache<Texture> mTextures; // drops and splashes
+	float mDensity{ 1.0f };
+	float mSpawnCredit{ 0.0f };
+};
+
+// --------------------------------------------------------------------------------
+// Day and night over the world. After dusk a light map darkens everything below
+// the HUD, lit by fixed lamps and a lantern that follows the player
+class Sky
+{
+public:
+	Sky(const sf::Vector2f& worldSize, const std::vector<PointLight>& lamps, const sf::Vector2f& playerCenter)
+		: mLightMap(worldSize, LIGHT_CELL_SIZE)
 	{
-		ResourceLocator& locator = ResourceLocator::GetInstance();
-		AssetManager& assetManager = locator.GetAssetManager();
-		Texture& textureContainer = assetManager.GetAsset<Texture>(textureId);
-		return textureContainer.GetRawTexture();
+		for (const PointLight& lamp : lamps)
+		{
+			mLightMap.AddLight(lamp);
+		}
+		mLantern = mLightMap.AddLight({ playerCenter, LANTERN_RADIUS, LANTERN_COLOR });
 	}
 
-	Group& mAllSprites;
-    Scene& mScene;
-};
\ No newline at end of file
+	void Update(uint32_t minuteOfDay, const sf::Vector2f& playerCenter)
+	{
+		mLightMap.SetAmbient(GetAmbientColor(minuteOfDay));
+		mLightMap.MoveLight(mLantern, playerCenter);
+		mLightMap.Update();
+	}
+
+	void Draw(RenderCommandList& commands) { mLightMap.Draw(commands); }
+
+	// White through the day, fading to the night colour over the twilight hours
+	static sf::Color GetAmbientColor(uint32_t minuteOfDay)
+	{
+		float darkness = 1.0f;
+		if (minuteOfDay >= DAWN_START_MINUTE && minuteOfDay < DUSK_START_MINUTE)
+		{
+			const float sinceDawn = static_cast<float>(minuteOfDay - DAWN_START_MINUTE) / TWILIGHT_MINUTES;
+			darkness = std::max(0.0f, 1.0f - sinceDawn);
+		}
+		else if (minuteOfDay >= DUSK_START_MINUTE)
+		{
+			darkness = std::min(1.0f, static_cast<float>(minuteOfDay - DUSK_START_MINUTE) / TWILIGHT_MINUTES);
+		}
+
+		auto blend = [darkness](uint8_t day, uint8_t night) {
+			return static_cast<uint8_t>(day + (night - day) * darkness + 0.5f);
+		};
+		return sf::Color(blend(255, NIGHT_AMBIENT.r), blend(255, NIGHT_AMBIENT.g), blend(255, NIGHT_AMBIENT.b));
+	}
+
+	static inline const sf::Color NIGHT_AMBIENT{ 60, 70, 120 };
+	static inline const sf::Color LANTERN_COLOR{ 255, 200, 130 };
+	static inline const sf::Color LAMP_COLOR{ 255, 180, 100 };
+
+private:
+	LightMap mLightMap;
+	LightId mLantern;
+};
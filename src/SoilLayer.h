@@ -11,6 +11,11 @@
 #include "Core/Scene.h"
 #include "Core/Tiled/TiledMap.h"
 #include "Core/Utils.h"
+#include "Core/BinaryStream.h"
+#include "Core/Collision/RectBatch.h"
+
+// System
+#include <array>
 
 //------------------------------------------------------------------------------
 struct SoilCell
@@ -18,24 +23,28 @@ struct SoilCell
     bool mFarmable{ false };
     bool mIsHit{ false };
     bool mIsWatered{ false };
+    uint8_t mWaterVariant{ 0 };
+    uint8_t mSoilShape{ 0 }; // hit neighbours the soil sprite was picked for
     sf::FloatRect mBounds;
     sf::Vector2i mTileIndex;
+    GameObject* mSoilSprite{ nullptr };
+    GameObject* mWaterSprite{ nullptr };
 };
 
 //------------------------------------------------------------------------------
 class SoilLayer
 {
 public:
-    SoilLayer(Group& allSprites, Scene& scene)
+    SoilLayer(Group& allSprites, Scene& scene, TiledMap& map)
         : mAllSprites(allSprites)
         , mScene(scene)
         , mSoilSprites(*scene.CreateGroup())
         , mWaterSprites(*scene.CreateGroup())
+        , mMap(&map)
+        , mTextures(ResourceLocator::GetInstance().GetAssetManager())
         , mIsRaining(false)
         , mWaterTextureIds({ "water_0", "water_1", "water_2" })
     {
-        AssetManager& assetManager = ResourceLocator::GetInstance().GetAssetManager();
-        mMap = &assetManager.GetAsset<TiledMap>("main");
         mGrid.resize(mMap->GetTileCount());
 
         tson::Layer* farmableLayer = mMap->GetLayerByName("Farmable");
@@ -50,18 +59,30 @@ public:
             soilTile.mTileIndex = sf::Vector2i(tilePos.x, tilePos.y);
             soilTile.mFarmable = true;
         }
+
+        // Only farmable cells can be hit, so tool queries scan their bounds alone
+        for (size_t index = 0; index < mGrid.size(); index++)
+        {
+            if (mGrid[index].mFarmable)
+            {
+                mFarmableBounds.Add(mGrid[index].mBounds);
+                mFarmableCells.push_back(static_cast<uint32_t>(index));
+            }
+        }
     }
 
     void SetIsRaining(bool flag) { mIsRaining = flag; }
 
     void HoeSoil(const sf::Vector2f point)
     {
-        for (SoilCell& soilTile : mGrid)
+        for (size_t index = mFarmableBounds.FindFirstContaining(point); index != RectBatch::NONE;
+             index = mFarmableBounds.FindFirstContaining(point, index + 1))
         {
-            if (soilTile.mBounds.contains(point))
+            SoilCell& tile = mGrid[mFarmableCells[index]];
+            if (!tile.mIsHit)
             {
-                soilTile.mIsHit = true;
-                CreateSoilTiles();
+                tile.mIsHit = true;
+                RefreshSoilTiles(tile.mTileIndex);
             }
         }
 
@@ -73,9 +94,11 @@ public:
 
     void WaterSoil(const sf::Vector2f point)
     {        
-        for (SoilCell& tile : mGrid)
+        for (size_t index = mFarmableBounds.FindFirstContaining(point); index != RectBatch::NONE;
+             index = mFarmableBounds.FindFirstContaining(point, index + 1))
         {
-            if (tile.mIsHit && tile.mBounds.contains(point))
+            SoilCell& tile = mGrid[mFarmableCells[index]];
+            if (tile.mIsHit)
             {
                 CreateWaterTile(tile);
             }
@@ -95,76 +118,168 @@ public:
 
     void RemoveAllWaterSoilTiles()
     {
-        for (GameObject* gameObject : mWaterSprites)
+        for (SoilCell& tile : mGrid)
         {
-            gameObject->Kill();
+            RemoveSprite(tile.mWaterSprite);
+            tile.mIsWatered = false;
         }
+    }
 
-        for (SoilCell& tile : mGrid)
+    // Snapshot: one flag byte per cell, written as a single block
+    void SaveState(BinaryWriter& writer)
+    {
+        mStateScratch.resize(mGrid.size());
+        for (size_t index = 0; index < mGrid.size(); index++)
         {
-            tile.mIsWatered = false;
+            const SoilCell& cell = mGrid[index];
+            mStateScratch[index] = (cell.mIsHit ? CELL_HIT : 0)
+                                 | (cell.mIsWatered ? CELL_WATERED : 0)
+                                 | (cell.mWaterVariant << CELL_VARIANT_SHIFT);
+        }
+        writer.WriteArray(mStateScratch.data(), mStateScratch.size());
+    }
+
+    // Only cells that differ from the live grid touch their sprites, so restoring a
+    // near-identical snapshot, as rollback does every frame, costs a scan of the bytes
+    void RestoreState(BinaryReader& reader)
+    {
+        reader.ReadArray(mStateScratch);
+        if (mStateScratch.size() != mGrid.size())
+        {
+            throw std::runtime_error("Soil snapshot does not match the map size");
+        }
+
+        mChangedCells.clear();
+        for (size_t index = 0; index < mGrid.size(); index++)
+        {
+            SoilCell& cell = mGrid[index];
+            const bool isHit = (mStateScratch[index] & CELL_HIT) != 0;
+            const bool isWatered = (mStateScratch[index] & CELL_WATERED) != 0;
+            const uint8_t waterVariant = mStateScratch[index] >> CELL_VARIANT_SHIFT;
+
+            if (cell.mIsWatered != isWatered || (isWatered && cell.mWaterVariant != waterVariant))
+            {
+                RemoveSprite(cell.mWaterSprite);
+                cell.mIsWatered = isWatered;
+                cell.mWaterVariant = waterVariant;
+                if (isWatered)
+                {
+                    AddWaterTile(cell);
+                }
+            }
+            else
+            {
+                cell.mWaterVariant = waterVariant;
+            }
+
+            if (cell.mIsHit != isHit)
+            {
+                cell.mIsHit = isHit;
+                mChangedCells.push_back(static_cast<uint32_t>(index));
+            }
+        }
+
+        // After every flag is restored, a soil sprite's shape depends on its neighbours
+        for (uint32_t index : mChangedCells)
+        {
+            RefreshSoilTiles(mGrid[index].mTileIndex);
         }
     }
 
 private:
+    static constexpr uint8_t CELL_HIT = 1 << 0;
+    static constexpr uint8_t CELL_WATERED = 1 << 1;
+    static constexpr uint8_t CELL_VARIANT_SHIFT = 2;
+
+    static constexpr uint8_t SHAPE_TOP = 1 << 0;
+    static constexpr uint8_t SHAPE_BOTTOM = 1 << 1;
+    static constexpr uint8_t SHAPE_RIGHT = 1 << 2;
+    static constexpr uint8_t SHAPE_LEFT = 1 << 3;
+
+    // Soil texture for each combination of SHAPE bits
+    inline static const std::array<std::string, 16> SOIL_TILE_TYPES =
+    {
+        "o",   "b",   "t",   "tb",
+        "l",   "bl",  "tl",  "tbr",
+        "r",   "br",  "tr",  "tbl",
+        "lr",  "lrb", "lrt", "x"
+    };
+
     void CreateWaterTile(SoilCell& soilTile)
     {
+        RemoveSprite(soilTile.mWaterSprite);
         soilTile.mIsWatered = true;
-        AddTile(GetRandomElement(mWaterTextureIds), soilTile.mTileIndex, 4, mWaterSprites);
+        soilTile.mWaterVariant = static_cast<uint8_t>(RandomInteger(0, static_cast<int32_t>(mWaterTextureIds.size()) - 1));
+        AddWaterTile(soilTile);
     }
 
-    void CreateSoilTiles()
+    void AddWaterTile(SoilCell& soilTile)
     {
-        for (GameObject* gameObject : mSoilSprites)
+        soilTile.mWaterSprite = AddTile(mWaterTextureIds.at(soilTile.mWaterVariant), soilTile.mTileIndex, 4, mWaterSprites);
+    }
+
+    // A hit tile's shape follows its neighbours, so they are refreshed with it
+    void RefreshSoilTiles(const sf::Vector2i& tileIndex)
+    {
+        RefreshSoilTile(tileIndex.x, tileIndex.y);
+        RefreshSoilTile(tileIndex.x, tileIndex.y - 1);
+        RefreshSoilTile(tileIndex.x, tileIndex.y + 1);
+        RefreshSoilTile(tileIndex.x + 1, tileIndex.y);
+        RefreshSoilTile(tileIndex.x - 1, tileIndex.y);
+    }
+
+    // Replaces the cell's soil sprite only when its shape changed
+    void RefreshSoilTile(int32_t x, int32_t y)
+    {
+        if (!IsInsideGrid(x, y))
         {
-            gameObject->Kill();
+            return;
         }
 
-        for (const SoilCell& tile : mGrid)
+        SoilCell& tile = mGrid[TileIndex(x, y)];
+        if (!tile.mIsHit)
         {
-            if (tile.mIsHit)
-            {
-                bool t = mGrid.at(TileIndex(tile.mTileIndex.x, tile.mTileIndex.y - 1)).mIsHit;
-                bool b = mGrid.at(TileIndex(tile.mTileIndex.x, tile.mTileIndex.y + 1)).mIsHit;
-                bool r = mGrid.at(TileIndex(tile.mTileIndex.x + 1, tile.mTileIndex.y)).mIsHit;
-                bool l = mGrid.at(TileIndex(tile.mTileIndex.x - 1, tile.mTileIndex.y)).mIsHit;
-
-                std::string tileType = "o";
-
-                // all sides
-                if (t && b && r && l) { tileType = "x"; }
-
-                // horizontal tiles only
-                if (l && !(t || r || b)) { tileType = "r"; }
-                if (r && !(t || l || b)) { tileType = "l"; }
-                if (r && l && !(t || b)) { tileType = "lr"; }
-
-                // vertical tiles only
-                if (t && !(r || l || b)) { tileType = "b"; }
-                if (b && !(r || l || t)) { tileType = "t"; }
-                if (b && t && !(r || l)) { tileType = "tb"; }
-
-                // corners
-                if (l && b && !(t || r)) { tileType = "tr"; }
-                if (r && b && !(t || l)) { tileType = "tl"; }
-                if (l && t && !(b || r)) { tileType = "br"; }
-                if (r && t && !(b || l)) { tileType = "bl"; }
-
-                // T shapes
-                if ((t && b && r) && !l) { tileType = "tbr"; }
-                if ((t && b && l) && !r) { tileType = "tbl"; }
-                if ((l && r && t) && !b) { tileType = "lrb"; }
-                if ((l && r && b) && !t) { tileType = "lrt"; }
-
-                AddTile(tileType, tile.mTileIndex, 3, mSoilSprites);
-            }
+            RemoveSprite(tile.mSoilSprite);
+            return;
+        }
+
+        const uint8_t shape = (IsHit(x, y - 1) ? SHAPE_TOP : 0)
+                            | (IsHit(x, y + 1) ? SHAPE_BOTTOM : 0)
+                            | (IsHit(x + 1, y) ? SHAPE_RIGHT : 0)
+                            | (IsHit(x - 1, y) ? SHAPE_LEFT : 0);
+        if (tile.mSoilSprite && tile.mSoilShape == shape)
+        {
+            return;
+        }
+
+        RemoveSprite(tile.mSoilSprite);
+        tile.mSoilShape = shape;
+        tile.mSoilSprite = AddTile(SOIL_TILE_TYPES[shape], tile.mTileIndex, 3, mSoilSprites);
+    }
+
+    bool IsInsideGrid(int32_t x, int32_t y)
+    {
+        const sf::Vector2i tileCount = mMap->GetTileCount2Dim();
+        return x >= 0 && y >= 0 && x < tileCount.x && y < tileCount.y;
+    }
+
+    bool IsHit(int32_t x, int32_t y)
+    {
+        return IsInsideGrid(x, y) && mGrid[TileIndex(x, y)].mIsHit;
+    }
+
+    static void RemoveSprite(GameObject*& sprite)
+    {
+        if (sprite)
+        {
+            sprite->Kill();
+            sprite = nullptr;
         }
     }
 
-    void AddTile(const std::string& tileType, sf::Vector2i tileIndex, uint16_t depth, Group& group)
+    GameObject* AddTile(const std::string& tileType, sf::Vector2i tileIndex, uint16_t depth, Group& group)
     {
-        AssetManager& assetManager = ResourceLocator::GetInstance().GetAssetManager();
-        sf::Texture& texture = assetManager.GetAsset<Texture>(tileType).GetRawTexture();
+        sf::Texture& texture = mTextures.Get(tileType).GetRawTexture();
         sf::IntRect textureRegion(sf::Vector2i(), sf::Vector2i(texture.getSize()));
         
         float posX = tileIndex.x * mMap->GetTileSize().x;
@@ -177,6 +292,7 @@ private:
                                                        depth);
         group.Add(sprite);
         mAllSprites.Add(sprite);
+        return sprite;
     }
 
     size_t TileIndex(size_t x, size_t y)
@@ -185,11 +301,16 @@ private:
     }
 
     std::vector<SoilCell> mGrid;
+    RectBatch mFarmableBounds;
+    std::vector<uint32_t> mFarmableCells;
     Group& mAllSprites;
     Scene& mScene;
     Group& mSoilSprites;
     Group& mWaterSprites;
     TiledMap* mMap;
+    AssetHandleCache<Texture> mTextures;
     bool mIsRaining;
     std::vector<std::string> mWaterTextureIds;
+    std::vector<uint8_t> mStateScratch;
+    std::vector<uint32_t> mChangedCells;
 };
\ No newline at end of file
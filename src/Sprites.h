@@ -8,7 +8,7 @@
 #include "Core/Texture.h"
 #include "Core/Utils.h"
 #include "Core/Scene.h"
-#include "Core/Timer.h"
+#include "Core/TimerWheel.h"
 #include "Core/Shader.h"
 #include "Core/ResourceLocator.h"
 
@@ -59,6 +59,7 @@ protected:
 	{
 		mSprite.setTexture(texture);
 		mSprite.setTextureRect(textureRect);
+		InvalidateTransform();
 	}	
 
 private:
@@ -124,24 +125,26 @@ public:
 		     const sf::Vector2f& origin, const sf::Vector2f& position, uint16_t depth, 
 		     int32_t msDuration)
 		: Generic(texture, textureRegion, origin, position, depth)
-		, mTimer(sf::milliseconds(msDuration))
+		, mDuration(sf::milliseconds(msDuration))
+		, mShader(ResourceLocator::GetInstance().GetAssetManager().AcquireAsset<Shader>("color"))
 	{ 
-		AssetManager& assetManager = ResourceLocator::GetInstance().GetAssetManager();
-		SetShader(&assetManager.GetAsset<Shader>("color"));
-		mTimer.Start();
+		SetShader(&mShader.Get());
 	}
 
-	virtual void Update(const sf::Time& timestamp) 
+	~Particle()
 	{
-		mTimer.Update(timestamp);
-		if (mTimer.IsFinished())
-		{
-			Kill();
-		}
-	};
+		GetScene().GetTimerWheel().Cancel(mTimer);
+	}
+
+	virtual void SetUp(Scene& scene) override
+	{
+		mTimer = scene.GetTimerWheel().Schedule(mDuration, [this]() { Kill(); });
+	}
 
 private:
-	Timer mTimer;
+	sf::Time mDuration;
+	AssetHandle<Shader> mShader;
+	TimerHandle mTimer;
 };
 
 //------------------------------------------------------------------------------
@@ -7,6 +7,7 @@
 
 // Core
 #include "Core/ILayer.h"
+#include "Core/Render/RenderCommandList.h"
 #include "Core/Timer.h"
 #include "Core/ResourceLocator.h"
 
@@ -53,9 +54,9 @@ public:
 		}
 	}
 
-	virtual void Draw(sf::RenderWindow& window) 
+	virtual void Draw(RenderCommandList& commands) 
 	{ 
-		window.draw(mOverlay);
+		commands.draw(mOverlay);
 	}
 
 private:
@@ -9,16 +9,20 @@
 #include "Core/Utils.h"
 #include "Core/Scene.h"
 #include "Core/ResourceLocator.h"
+#include "Core/Events/EventBus.h"
 
+#include "GameEvents.h"
 #include "Settings.h"
 #include "Sprites.h"
 
+#include <array>
+
 
 // --------------------------------------------------------------------------------
 class ITreeObserver
 {
 public:
-	virtual void AddItem(const std::string& item) { }
+	virtual void HitboxChanged(const sf::FloatRect& oldHitbox, const sf::FloatRect& newHitbox) { }
 };
 
 //------------------------------------------------------------------------------
@@ -27,11 +31,11 @@ class TreeSubject
 public:
 	void Subscribe(ITreeObserver* observer) { mObservers.emplace_back(observer); }
 
-	void AddItem(const std::string& item)
+	void HitboxChanged(const sf::FloatRect& oldHitbox, const sf::FloatRect& newHitbox)
 	{
 		for (auto& observer : mObservers)
 		{
-			observer->AddItem(item);
+			observer->HitboxChanged(oldHitbox, newHitbox);
 		}
 	}
 
@@ -39,6 +43,16 @@ private:
 	std::vector<ITreeObserver*> mObservers;
 };
 
+//------------------------------------------------------------------------------
+// Snapshot record, trees are written as one contiguous block
+struct TreeState
+{
+	int32_t mHealth;
+	uint8_t mAlive;
+	uint8_t mAppleMask; // bit n set when APPLE_POSITIONS slot n holds an apple
+	uint8_t mPadding[2];
+};
+
 //------------------------------------------------------------------------------
 class Tree : public TiledMapObjectSprite, public TreeSubject
 {
@@ -49,13 +63,19 @@ public:
 		, mSpriteGroup(spriteGroup)
 		, mAlive(true)
 		, mHealth(5)
+		, mTreeTexture(definition.GetTexture())
+		, mTreeTextureRegion(definition.GetTextureRegion())
+		, mTreeOrigin(definition.GetOrigin())
+		, mTreePosition(definition.GetPosition())
+		, mAppleTexture(ResourceLocator::GetInstance().GetAssetManager().AcquireAsset<Texture>("apple"))
 	{
 		SetOrigin(definition.GetOrigin());
+		mTreeHitbox = GetHitbox();
+		mApples.resize(APPLE_POSITIONS.at(mName).size(), nullptr);
 	}
 
 	virtual void SetUp(Scene& scene) override
 	{
-		mAppleGroup = scene.CreateGroup();
 		CreateFruit();
 	}
 
@@ -74,59 +94,115 @@ public:
 			mHealth -= 1;
 		}
 		PickApple();
+
+		// Dies on its next update, which a distant tree would otherwise wait for
+		GetScene().WakeGameObject(this);
 	}
 
 	void CreateFruit()
 	{
-		sf::FloatRect bounds = GetGlobalBounds();
-		const sf::Vector2f position = sf::Vector2f(bounds.left, bounds.top);
-
-		AssetManager& assetManager = ResourceLocator::GetInstance().GetAssetManager();
-		for (const sf::Vector2f& positionOffset : APPLE_POSITIONS.at(mName))
+		for (size_t slot = 0; slot < mApples.size(); slot++)
 		{
 			if (IsRandomNumberLessThanOrEqualTo(0, 10, 2))
 			{
-				const sf::Texture& texture = assetManager.GetAsset<Texture>("apple").GetRawTexture();
-				const sf::IntRect textureRegion(sf::Vector2i(), sf::Vector2i(texture.getSize()));
-
-				Generic* apple = GetScene().CreateGameObject<Generic>(texture,
-					textureRegion,
-					sf::Vector2f(),
-					position + positionOffset,
-					6);
-				mSpriteGroup.Add(apple);
-				mAppleGroup->Add(apple);
+				CreateApple(slot);
 			}
 		}
 	}
 
 	void KillAllApples()
 	{
-		for (GameObject* apple : *mAppleGroup)
+		for (GameObject*& apple : mApples)
 		{
-			if (!apple->IsMarkedForRemoval())
+			if (apple && !apple->IsMarkedForRemoval())
 			{
 				apple->Kill();
 			}
+			apple = nullptr;
+		}
+	}
+
+	TreeState GetState() const
+	{
+		TreeState state{ mHealth, mAlive, 0, { 0, 0 } };
+		for (size_t slot = 0; slot < mApples.size(); slot++)
+		{
+			if (mApples[slot])
+			{
+				state.mAppleMask |= 1 << slot;
+			}
+		}
+		return state;
+	}
+
+	void SetState(const TreeState& state)
+	{
+		if (mAlive && !state.mAlive)
+		{
+			ApplyStump();
+		}
+		else if (!mAlive && state.mAlive)
+		{
+			ApplyTree();
+		}
+		mAlive = state.mAlive != 0;
+		mHealth = state.mHealth;
+
+		// Only slots that differ gain or lose their apple
+		for (size_t slot = 0; slot < mApples.size(); slot++)
+		{
+			const bool hasApple = (state.mAppleMask & (1 << slot)) != 0;
+			if (mApples[slot] && !hasApple)
+			{
+				mApples[slot]->Kill();
+				mApples[slot] = nullptr;
+			}
+			else if (!mApples[slot] && hasApple)
+			{
+				CreateApple(slot);
+			}
 		}
 	}
 
 private:
+	void CreateApple(size_t slot)
+	{
+		sf::FloatRect bounds = GetGlobalBounds();
+		const sf::Vector2f position = sf::Vector2f(bounds.left, bounds.top);
+
+		const sf::Texture& texture = mAppleTexture->GetRawTexture();
+		const sf::IntRect textureRegion(sf::Vector2i(), sf::Vector2i(texture.getSize()));
+
+		Generic* apple = GetScene().CreateGameObject<Generic>(texture,
+			textureRegion,
+			sf::Vector2f(),
+			position + APPLE_POSITIONS.at(mName)[slot],
+			6);
+		mSpriteGroup.Add(apple);
+		mApples[slot] = apple;
+	}
+
 	void CheckDeath()
 	{
 		if (mHealth <= 0)
 		{
 			ReplaceTreeWithStump();
 			mAlive = false;
-			AddItem("wood");
+			CollectItem(InventoryItem::Wood);
 		}
 	}
 
 	void ReplaceTreeWithStump()
 	{
-		AssetManager& assetManager = ResourceLocator::GetInstance().GetAssetManager();
-
 		CreateSilhouetteFlash(static_cast<Generic*>(this), 5, 200);
+		ApplyStump();
+		KillAllApples();
+		mAlive = false;
+	}
+
+	void ApplyStump()
+	{
+		AssetManager& assetManager = ResourceLocator::GetInstance().GetAssetManager();
 
 		static const std::unordered_map<std::string, std::string> textureMap =
 		{
@@ -141,7 +217,8 @@ private:
 		}
 
 		sf::FloatRect oldBounds = GetGlobalBounds();
-		sf::Texture* texture = &assetManager.GetAsset<Texture>(it->second).GetRawTexture();
+		mStumpTexture = assetManager.AcquireAsset<Texture>(it->second);
+		sf::Texture* texture = &mStumpTexture->GetRawTexture();
 
 		// Update sprite texture
 		SetTexture(*texture, { sf::Vector2i(), sf::Vector2i(texture->getSize()) });
@@ -149,27 +226,60 @@ private:
 		SetPosition({ oldBounds.left + oldBounds.width / 2.0f, GetPosition().y });  // Tiled map origin is BL
 
 		// Update hitbox
+		sf::FloatRect oldHitbox = GetHitbox();
 		sf::FloatRect newBounds = GetGlobalBounds();
 		SetHitbox(InflateRect(newBounds, -10.0f, -newBounds.height * 0.6f));
+		HitboxChanged(oldHitbox, GetHitbox());
+	}
 
+	void ApplyTree()
+	{
+		SetTexture(*mTreeTexture, mTreeTextureRegion);
+		SetOrigin(mTreeOrigin);
+		SetPosition(mTreePosition);
 
-		KillAllApples();
-		mAlive = false;
+		sf::FloatRect oldHitbox = GetHitbox();
+		SetHitbox(mTreeHitbox);
+		HitboxChanged(oldHitbox, GetHitbox());
 	}
 
 	void PickApple()
 	{
-		GameObject* apple = mAppleGroup->GetRandomGameObject();
-		if (apple)
+		std::array<size_t, 8> occupiedSlots;
+		size_t occupiedCount = 0;
+		for (size_t slot = 0; slot < mApples.size(); slot++)
+		{
+			if (mApples[slot])
+			{
+				occupiedSlots[occupiedCount++] = slot;
+			}
+		}
+
+		if (occupiedCount > 0)
 		{
+			size_t slot = occupiedSlots[RandomInteger(0, static_cast<int32_t>(occupiedCount) - 1)];
+			GameObject* apple = mApples[slot];
 			CreateSilhouetteFlash(static_cast<Generic*>(apple), 6, 200);
 			apple->Kill();
-			AddItem("apple");
+			mApples[slot] = nullptr;
+			CollectItem(InventoryItem::Apple);
 		}
 	}
 
+	// Deferred to the end of the frame, with everything else collected in it
+	void CollectItem(InventoryItem item)
+	{
+		GetScene().GetEventBus().Publish(ItemCollectedEvent{ item, 1 });
+	}
+
 	void CreateSilhouetteFlash(const Generic* source, uint16_t depth, int32_t msDuration)
 	{
+		const QualityLevel quality = ResourceLocator::GetInstance().GetQualityGovernor().GetLevel();
+		if (!SelectForQuality(EFFECT_PARTICLES, quality))
+		{
+			return;
+		}
+
 		const sf::FloatRect& bounds = source->GetGlobalBounds();
 		const sf::Texture& texture = source->GetSprite().getTexture();
 		const sf::IntRect textureRegion(sf::Vector2i(), sf::Vector2i(texture.getSize()));
@@ -186,6 +296,16 @@ private:
 	std::string mName;
 	int32_t mHealth;
 	bool mAlive;
-	Group* mAppleGroup;
+	std::vector<GameObject*> mApples; // indexed by APPLE_POSITIONS slot
 	Group& mSpriteGroup;
+
+	// Original appearance, restored when a snapshot brings a stump back to life
+	const sf::Texture* mTreeTexture;
+	sf::IntRect mTreeTextureRegion;
+	sf::Vector2f mTreeOrigin;
+	sf::Vector2f mTreePosition;
+
+	AssetHandle<Texture> mAppleTexture;
+	AssetHandle<Texture> mStumpTexture;
+	sf::FloatRect mTreeHitbox;
 };
\ No newline at end of file
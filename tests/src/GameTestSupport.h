@@ -0,0 +1,18 @@
+#pragma once
+
+#include "GameAssets.h"
+#include "Settings.h"
+
+#include "Core/ResourceLocator.h"
+
+// Registers every game asset once, shared by all game tests
+inline AssetManager& LoadGameAssets()
+{
+    static AssetManager& assetManager = []() -> AssetManager& {
+        ResourceLocator& locator = ResourceLocator::GetInstance();
+        locator.Initialize(ApplicationConfig{ WIDTH, HEIGHT, 32, CAPTION });
+        RegisterGameAssets(locator.GetAssetManager(), AssetLoadPolicy::Eager);
+        return locator.GetAssetManager();
+    }();
+    return assetManager;
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include "MapGenerator.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+    std::string ReadText(const std::filesystem::path& path)
+    {
+        std::ifstream stream(path);
+        std::ostringstream text;
+        text << stream.rdbuf();
+        return text.str();
+    }
+
+    TEST(MapGeneratorTests, SameSeedWritesTheSameMap)
+    {
+        const std::filesystem::path directory = std::filesystem::temp_directory_path() / "pydew_map_generator";
+        MapGeneratorConfig config;
+
+        const GeneratedMapStats first = GenerateMap(config, (directory / "first.json").string());
+        const GeneratedMapStats second = GenerateMap(config, (directory / "second.json").string());
+        EXPECT_EQ(first.mTreeCount, second.mTreeCount);
+        EXPECT_EQ(ReadText(directory / "first.json"), ReadText(directory / "second.json"));
+
+        config.mSeed++;
+        GenerateMap(config, (directory / "third.json").string());
+        EXPECT_NE(ReadText(directory / "first.json"), ReadText(directory / "third.json"));
+
+        std::filesystem::remove_all(directory);
+    }
+
+    TEST(MapGeneratorTests, ScenariosScaleWithArea)
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "pydew_map_generator" / "forest.json";
+        const MapScenario* scenario = FindMapScenario("dense-forest");
+        ASSERT_NE(scenario, nullptr);
+
+        const GeneratedMapStats small = GenerateMap(ScaleMapConfig(scenario->mConfig, 1), path.string());
+        const GeneratedMapStats large = GenerateMap(ScaleMapConfig(scenario->mConfig, 16), path.string());
+        EXPECT_NEAR(large.mTileCount, small.mTileCount * 16.0, small.mTileCount * 0.1);
+        EXPECT_GT(large.mTreeCount, small.mTreeCount * 8);
+        EXPECT_GT(large.mFarmableTiles, 0u);
+        EXPECT_EQ(large.mLayerCount, small.mLayerCount);
+
+        const std::string text = ReadText(path);
+        for (const char* key : { "\"Collision\"", "\"Farmable\"", "\"Trees\"", "\"Player\"", "\"rainChance\"" })
+        {
+            EXPECT_NE(text.find(key), std::string::npos) << key;
+        }
+
+        std::filesystem::remove_all(path.parent_path());
+        EXPECT_EQ(FindMapScenario("missing"), nullptr);
+    }
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "GameTestSupport.h"
+#include "Overlay.h"
+#include "Player.h"
+#include "SoilLayer.h"
+
+#include "Core/Collision/StaticCollisionMap.h"
+#include "Core/Input/InputSystem.h"
+#include "Core/Scene.h"
+
+namespace {
+
+    // A player on the main map with nothing around it, enough to drive the HUD
+    struct OverlayFixture
+    {
+        OverlayFixture()
+            : mAssetManager(LoadGameAssets())
+            , mMap(mAssetManager.GetAsset<TiledMap>("main"))
+            , mAllSprites(*mScene.CreateGroup())
+            , mCollisionSprites(*mScene.CreateGroup())
+            , mTreeSprites(*mScene.CreateGroup())
+            , mInteractionSprites(*mScene.CreateGroup())
+            , mSoilLayer(mAllSprites, mScene, mMap)
+            , mStaticCollision(sf::Vector2u(mMap.GetTileCount2Dim()), mMap.GetTileSize(), sf::Vector2f())
+            , mPlayer(*mScene.CreateGameObject<Player>(mAssetManager, mInput, sf::Vector2f(400.0f, 400.0f),
+                mStaticCollision, mCollisionSprites, mTreeSprites, mInteractionSprites, mSoilLayer, LAYERS.at("main")))
+            , mOverlay(mAssetManager, mPlayer, sf::Vector2u(WIDTH, HEIGHT))
+        { }
+
+        void DrawFrame()
+        {
+            mOverlay.Draw(mCommands);
+            mCommands.Reset();
+        }
+
+        AssetManager& mAssetManager;
+        TiledMap& mMap;
+        Scene mScene;
+        Group& mAllSprites;
+        Group& mCollisionSprites;
+        Group& mTreeSprites;
+        Group& mInteractionSprites;
+        SoilLayer mSoilLayer;
+        StaticCollisionMap mStaticCollision;
+        InputSystem mInput;
+        Player& mPlayer;
+        Overlay mOverlay;
+        RenderCommandList mCommands;
+    };
+
+    TEST(OverlayTests, SteadyFramesDoNotRedraw)
+    {
+        OverlayFixture fixture;
+        const HudStats stats{ sf::milliseconds(16), 120, 2 };
+        fixture.mOverlay.SetTimeOfDay(6 * 60);
+        fixture.mOverlay.SetDebugStats(stats);
+        fixture.DrawFrame();
+        const uint32_t redrawCount = fixture.mOverlay.GetRedrawCount();
+        EXPECT_GE(redrawCount, 1u);
+
+        // The level sets the clock every frame, unchanged values are only compared
+        for (int32_t frame = 0; frame < 120; frame++)
+        {
+            fixture.mOverlay.SetTimeOfDay(6 * 60);
+            fixture.mOverlay.SetDebugStats(stats);
+            fixture.DrawFrame();
+        }
+        EXPECT_EQ(fixture.mOverlay.GetRedrawCount(), redrawCount);
+
+        // A new minute redraws once, then the count is flat again
+        fixture.mOverlay.SetTimeOfDay(6 * 60 + 1);
+        fixture.DrawFrame();
+        fixture.DrawFrame();
+        EXPECT_EQ(fixture.mOverlay.GetRedrawCount(), redrawCount + 1);
+    }
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include "GameTestSupport.h"
+#include "Level.h"
+
+#include "Core/LayerStack.h"
+
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+
+    constexpr uint32_t SESSION_TICKS = 600;
+
+    // Walks, chops, hoes and waters, so the player, trees and soil all change
+    ActionSet PlaySession(uint32_t tick)
+    {
+        const uint32_t phase = tick / 60;
+        ActionSet actions = 0;
+        if (phase % 3 == 0) { actions |= ToActionBit(phase % 2 ? Action::MOVE_LEFT : Action::MOVE_UP); }
+        if (phase % 3 == 1) { actions |= ToActionBit(phase % 2 ? Action::MOVE_RIGHT : Action::MOVE_DOWN); }
+        if (tick % 40 == 20) { actions |= ToActionBit(Action::USE_TOOL); }
+        if (tick % 150 == 0) { actions |= ToActionBit(Action::SWITCH_TOOL); }
+        return actions;
+    }
+
+    // Runs a level the way Application does for a recorded or replayed session,
+    // seeded first and without pathfinding workers, then snapshots it
+    std::vector<uint8_t> RunSession(uint64_t seed, std::unique_ptr<IInputSource> source, const std::string& recordPath)
+    {
+        SeedRandom(seed);
+
+        LayerStack layerStack;
+        InputSystem& input = layerStack.GetInputSystem();
+        input.SetSource(std::move(source));
+        if (!recordPath.empty())
+        {
+            input.StartRecording(seed, SESSION_TICKS);
+        }
+
+        LevelOptions levelOptions;
+        levelOptions.mIsHeadless = true;
+        levelOptions.mPathfindingWorkers = 0;
+        levelOptions.mAutosaveFile.clear();
+
+        auto level = std::make_unique<Level>(levelOptions);
+        Level& levelRef = *level;
+        level->SetLayerStack(&layerStack);
+        layerStack.PushLayer(std::move(level));
+
+        while (!input.IsSourceFinished())
+        {
+            layerStack.Update(sf::seconds(1.0f / 60.0f));
+            layerStack.PostUpdate();
+        }
+
+        if (!recordPath.empty())
+        {
+            input.SaveRecording(recordPath);
+        }
+
+        std::vector<uint8_t> snapshot;
+        levelRef.SaveSnapshot(snapshot);
+        return snapshot;
+    }
+
+    TEST(ReplayTests, ReplayReachesTheRecordedSnapshot)
+    {
+        LoadGameAssets();
+        const std::string recordPath = (std::filesystem::temp_directory_path() / "pydew_replay_test.rec").string();
+
+        const std::vector<uint8_t> recorded = RunSession(20240611,
+            std::make_unique<ScriptedInputSource>(PlaySession, SESSION_TICKS), recordPath);
+
+        // Seeded from the recording alone, as a replayed session is
+        auto replay = std::make_unique<ReplayInputSource>(recordPath);
+        const uint64_t seed = replay->GetSeed();
+        EXPECT_EQ(replay->GetTickCount(), SESSION_TICKS);
+        const std::vector<uint8_t> replayed = RunSession(seed, std::move(replay), std::string());
+        std::remove(recordPath.c_str());
+
+        ASSERT_EQ(replayed.size(), recorded.size());
+        EXPECT_TRUE(replayed == recorded);
+    }
+
+}